@@ -0,0 +1,186 @@
+#pragma once
+
+// Modo de atracción: apenas el juego vuelve a IDLE, el LCD pasa a una
+// marquesina con la invitación completa arriba y un texto abajo. Si queda
+// en IDLE un rato, además muestra una demostración con los LEDs y, de vez
+// en cuando, una musiquita.
+//
+// Todo sale de tablas en flash y lo mueve el Scheduler: una tarea para los
+// cuadros de LEDs/tonos (su período es la duración de cada cuadro) y otra
+// que corre la marquesina (un comando al LCD por paso). Cualquier botón
+// arranca la partida en el GameController; update() lo nota en esa misma
+// pasada y corta todo antes de que corra otra tarea.
+//
+// Game es el GameController de la estación; los LEDs, el sonido y el
+// display son los tipos de sus periféricos.
+
+#include <Arduino.h>
+#include <avr/sleep.h>
+#include "Simon.h"
+#include "Scheduler.h"
+
+struct AttractFrame {
+  uint8_t leds;     // bit i = LED i
+  uint8_t tone10;   // frecuencia / 10; 0 = silencio
+  uint8_t ms10;     // duración / 10
+};
+
+// Vuelta, demostración de tres rondas (con los tonos de los botones) y
+// parpadeo
+const AttractFrame ATTRACT_SHOW[] PROGMEM = {
+  {1, 0, 12}, {2, 0, 12}, {4, 0, 12}, {8, 0, 12},
+  {1, 0, 12}, {2, 0, 12}, {4, 0, 12}, {8, 0, 12},
+  {0, 0, 60},
+  {1, 80, 40}, {0, 0, 80},
+  {1, 80, 40}, {0, 0, 20}, {4, 110, 40}, {0, 0, 80},
+  {1, 80, 40}, {0, 0, 20}, {4, 110, 40}, {0, 0, 20}, {2, 95, 40}, {0, 0, 80},
+  {15, 0, 25}, {0, 0, 25}, {15, 0, 25}, {0, 0, 25}, {15, 0, 25}, {0, 0, 100},
+};
+
+// Do-Mi-Sol-Do subiendo por los cuatro LEDs
+const AttractFrame ATTRACT_JINGLE[] PROGMEM = {
+  {1, 105, 12}, {2, 132, 12}, {4, 157, 12}, {8, 209, 30}, {0, 0, 80},
+};
+
+// Filas de la marquesina: hasta 40 caracteres cada una (la DDRAM)
+const char ATTRACT_PROMPT[] PROGMEM = "Presiona un boton para iniciar";
+const char ATTRACT_TEXT[] PROGMEM = "SIMON DICE * Repeti la secuencia * ";
+static_assert(sizeof(ATTRACT_PROMPT) <= 41 && sizeof(ATTRACT_TEXT) <= 41,
+              "la marquesina tiene 40 columnas");
+
+template <typename Game>
+class BasicAttractMode {
+public:
+  typedef typename Game::Leds    Leds;
+  typedef typename Game::Sound   Sound;
+  typedef typename Game::Display Display;
+
+  static const unsigned long kIdleMs = 20000;   // IDLE antes de arrancar
+  static const uint16_t kTextMs = 350;
+  static const uint8_t kJingleEvery = 3;        // vueltas entre musiquitas
+
+  BasicAttractMode(Scheduler& sched, Game& game, Leds& leds,
+                   Sound& buzzer, Display& display)
+    : sched_(sched), game_(game), leds_(leds), buzzer_(buzzer), display_(display),
+      frameTask_(-1), textTask_(-1), active_(false),
+      wasIdle_(false), frame_(0), cycle_(0), jingle_(false), frames_(0) {}
+
+  void begin() {
+    frameTask_ = sched_.add(frameThunk, this, 100);
+    textTask_ = sched_.add(textThunk, this, kTextMs);
+  }
+
+  // Después de game.loop(), en cada pasada
+  void update() {
+    update(Clock::now());
+  }
+
+  void update(Instant now) {
+    if (game_.state() != State::IDLE || game_.starting()) {
+      if (wasIdle_) leave();
+      return;
+    }
+    if (!wasIdle_) enter(now);
+    if (!active_ && now.since(idleSince_).ms >= kIdleMs) start(now);
+  }
+
+  bool active() const { return active_; }
+  uint32_t frames() const { return frames_; }
+
+private:
+  Scheduler& sched_;
+  Game& game_;
+  Leds& leds_;
+  Sound& buzzer_;
+  Display& display_;
+  int8_t frameTask_;
+  int8_t textTask_;
+  bool active_;
+  Instant idleSince_;
+  bool wasIdle_;
+  uint8_t frame_;
+  uint8_t cycle_;
+  bool jingle_;             // tocando ATTRACT_JINGLE en vez de ATTRACT_SHOW
+  uint32_t frames_;
+
+  static const uint8_t kShowLen = sizeof(ATTRACT_SHOW) / sizeof(AttractFrame);
+  static const uint8_t kJingleLen = sizeof(ATTRACT_JINGLE) / sizeof(AttractFrame);
+
+  static void frameThunk(void* ctx) { ((BasicAttractMode*)ctx)->nextFrame(); }
+  static void textThunk(void* ctx) { ((BasicAttractMode*)ctx)->nextText(); }
+
+  // La marquesina corre durante todo IDLE
+  void enter(Instant now) {
+    wasIdle_ = true;
+    idleSince_ = now;
+    display_.showMarquee(ATTRACT_PROMPT, ATTRACT_TEXT);
+    sched_.start(textTask_, kTextMs, now);
+  }
+
+  void leave() {
+    wasIdle_ = false;
+    sched_.stop(textTask_);
+    if (active_) stop();
+  }
+
+  void start(Instant now) {
+    active_ = true;
+    frame_ = 0;
+    cycle_ = 0;
+    jingle_ = false;
+    sched_.start(frameTask_, 0, now);
+  }
+
+  void stop() {
+    active_ = false;
+    sched_.stop(frameTask_);
+    buzzer_.stop();
+    leds_.offAll();
+  }
+
+  void nextFrame() {
+    const AttractFrame* f = (jingle_ ? ATTRACT_JINGLE : ATTRACT_SHOW) + frame_;
+    uint8_t mask = pgm_read_byte(&f->leds);
+    uint8_t tone10 = pgm_read_byte(&f->tone10);
+    uint16_t ms = (uint16_t)pgm_read_byte(&f->ms10) * 10;
+
+    leds_.apply(0xFF, mask);
+    if (tone10) buzzer_.beep(ms, (unsigned int)tone10 * 10);
+    sched_.setPeriod(frameTask_, ms);
+    ++frames_;
+
+    if (++frame_ >= (jingle_ ? kJingleLen : kShowLen)) {
+      frame_ = 0;
+      if (jingle_) {
+        jingle_ = false;
+      } else if (++cycle_ >= kJingleEvery) {
+        cycle_ = 0;
+        jingle_ = true;
+      }
+    }
+  }
+
+  void nextText() {
+    display_.marqueeStep();
+  }
+};
+
+typedef BasicAttractMode<GameController> AttractMode;
+
+// Una pasada de loop() de main.cpp, sin lo que depende de cómo se compiló
+// (EEPROM, Serial): el juego, la atracción y las tareas con el mismo
+// instante. En atracción no hay apuro y se duerme hasta la próxima
+// interrupción (el Timer0 despierta cada ms, así que los botones se siguen
+// leyendo); en el simulador solo se anota, para el consumo (host/Energy.h).
+// Los bancos del simulador corren esta misma pasada. true si durmió.
+template <typename Game>
+bool attractLoopPass(Game& game, BasicAttractMode<Game>& attract, Scheduler& sched,
+                     Instant now) {
+  game.loop(now);
+  attract.update(now);
+  uint16_t idleMs = sched.run(now);
+  if (!attract.active() || idleMs == 0) return false;
+  set_sleep_mode(SLEEP_MODE_IDLE);
+  sleep_mode();
+  return true;
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+// Calibración del antirrebote, botón por botón. Mientras dura recibe los
+// niveles crudos de cada pasada (antes del antirrebote) y mide cuánto
+// rebota cada contacto: una ráfaga empieza con la primera transición y
+// termina cuando pasan kQuietMs sin ninguna; su rebote va de la primera a
+// la última transición (0 si el contacto cambió limpio).
+//
+// Lo que pasa en los primeros kQuietMs no se cuenta: el botón con el que se
+// arrancó la calibración puede estar rebotando todavía.
+//
+// Junta un histograma por botón (de a 1 ms) y el rebote más largo. Con
+// kSamples ráfagas de cada botón (apretar y soltar son dos), la ventana es
+// ese máximo redondeado para arriba más kMarginMs: lo mínimo que todavía
+// no deja pasar un rebote visto. Un botón gastado rebota más y recibe una
+// ventana más larga; uno nuevo, más corta.
+
+#include <Arduino.h>
+
+class BounceCalibrator {
+public:
+  static const uint8_t kBins = 16;          // el último junta todo lo que sigue
+  static const uint8_t kSamples = 8;
+  static const uint16_t kQuietMs = 30;
+  static const uint8_t kMarginMs = 1;
+  static const uint8_t kMinMs = 2;
+  static const uint8_t kMaxMs = 40;
+
+  explicit BounceCalibrator(uint8_t count) : count_(count > 4 ? 4 : count) {
+    begin(0x0F, 0);
+  }
+
+  void begin(uint8_t levels, unsigned long nowUs) {
+    levels_ = levels;
+    startUs_ = nowUs;
+    for (uint8_t i = 0; i < 4; ++i) {
+      inBurst_[i] = false;
+      firstUs_[i] = lastUs_[i] = nowUs;
+      maxUs_[i] = 0;
+      samples_[i] = 0;
+      for (uint8_t b = 0; b < kBins; ++b) hist_[i][b] = 0;
+    }
+  }
+
+  // Cada pasada; devuelve el botón que cerró una ráfaga (0xFF si ninguno)
+  uint8_t sample(uint8_t levels, unsigned long nowUs) {
+    uint8_t changed = (uint8_t)(levels ^ levels_);
+    levels_ = levels;
+    if (nowUs - startUs_ < kQuietMs * 1000UL) return 0xFF;
+    uint8_t closed = 0xFF;
+    for (uint8_t i = 0; i < count_; ++i) {
+      if ((changed >> i) & 1) {
+        if (!inBurst_[i]) {
+          inBurst_[i] = true;
+          firstUs_[i] = nowUs;
+        }
+        lastUs_[i] = nowUs;
+      } else if (inBurst_[i] && nowUs - lastUs_[i] >= kQuietMs * 1000UL) {
+        inBurst_[i] = false;
+        record(i, lastUs_[i] - firstUs_[i]);
+        closed = i;
+      }
+    }
+    return closed;
+  }
+
+  bool done() const {
+    for (uint8_t i = 0; i < count_; ++i) {
+      if (samples_[i] < kSamples) return false;
+    }
+    return true;
+  }
+
+  uint8_t samples(uint8_t idx) const { return samples_[idx]; }
+  uint16_t maxBounceUs(uint8_t idx) const { return maxUs_[idx]; }
+  uint8_t bin(uint8_t idx, uint8_t b) const { return hist_[idx][b]; }
+
+  uint8_t window(uint8_t idx) const {
+    uint16_t ms = (uint16_t)((maxUs_[idx] + 999UL) / 1000 + kMarginMs);
+    if (ms < kMinMs) ms = kMinMs;
+    if (ms > kMaxMs) ms = kMaxMs;
+    return (uint8_t)ms;
+  }
+
+private:
+  uint8_t count_;
+  uint8_t levels_;
+  unsigned long startUs_;
+  bool inBurst_[4];
+  unsigned long firstUs_[4];
+  unsigned long lastUs_[4];
+  uint16_t maxUs_[4];
+  uint8_t samples_[4];
+  uint8_t hist_[4][kBins];
+
+  void record(uint8_t i, unsigned long us) {
+    uint16_t b = (uint16_t)(us / 1000);
+    if (b >= kBins) b = kBins - 1;
+    if (hist_[i][b] < 0xFF) ++hist_[i][b];
+    if (us > maxUs_[i]) maxUs_[i] = us > 0xFFFF ? 0xFFFF : (uint16_t)us;
+    if (samples_[i] < 0xFF) ++samples_[i];
+  }
+};
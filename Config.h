@@ -0,0 +1,177 @@
+#pragma once
+
+// Configuración en la EEPROM: lo que se ajusta en el menú de ajustes o por
+// la consola (Console.h) sobrevive a un apagado. Un bloque fijo con número
+// mágico, versión y CRC-16/CCITT; si algo no coincide (EEPROM borrada,
+// otra versión, bloque a medio grabar) se ignora y quedan los valores de
+// fábrica.
+//
+// Mapa de la EEPROM:
+//   0   SimonConfig (18 bytes)
+//   32  UsageRecord x USAGE_SLOTS (24 bytes cada uno, UsageStats.h)
+// Con varias estaciones (Stations.h) la estación k usa lo mismo corrido
+// k * STATION_EEPROM bytes; la 0 queda donde siempre.
+
+#include <Arduino.h>
+#include <EEPROM.h>
+#include "Simon.h"
+#include "EepromQueue.h"
+#include "UsageStats.h"
+
+const uint16_t CONFIG_ADDR = 0;
+const uint16_t STATION_EEPROM = 128;
+const uint8_t CONFIG_MAGIC = 0x5D;
+const uint8_t CONFIG_VERSION = 3;
+
+struct SimonConfig {
+  uint8_t magic;
+  uint8_t version;
+  uint8_t debounceMs[4];    // por botón (calibración)
+  uint16_t onMs;
+  uint16_t offMs;
+  uint16_t timeoutMs;
+  uint8_t winScore;
+  uint8_t colors;
+  uint8_t sound;
+  uint8_t reserved;
+  uint16_t crc;             // de todos los bytes anteriores
+};
+
+static_assert(sizeof(SimonConfig) == 18, "el bloque no puede tener relleno");
+
+// CRC-16/CCITT-FALSE (polinomio 0x1021, arranca en 0xFFFF), bit a bit:
+// son 16 bytes, no vale la pena una tabla en flash
+inline uint16_t crc16(const uint8_t* p, uint16_t n, uint16_t crc = 0xFFFF) {
+  while (n--) {
+    crc ^= (uint16_t)(*p++) << 8;
+    for (uint8_t b = 0; b < 8; ++b) {
+      crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+    }
+  }
+  return crc;
+}
+
+inline uint16_t configCrc(const SimonConfig& c) {
+  return crc16((const uint8_t*)&c, (uint16_t)(sizeof(c) - sizeof(c.crc)));
+}
+
+inline bool configValid(const SimonConfig& c) {
+  return c.magic == CONFIG_MAGIC && c.version == CONFIG_VERSION && c.crc == configCrc(c);
+}
+
+// false si el bloque no es válido (c queda con lo que se leyó). Directo de
+// la EEPROM: solo en setup(), antes de que haya algo en la cola.
+inline bool loadConfig(SimonConfig& c, uint8_t station = 0) {
+  EEPROM.get((int)(CONFIG_ADDR + station * STATION_EEPROM), c);
+  return configValid(c);
+}
+
+// Con la cola andando: ve lo que todavía no se grabó (EepromQueue::get)
+inline bool loadConfig(SimonConfig& c, EepromQueue& q, uint8_t station = 0) {
+  q.get((uint16_t)(CONFIG_ADDR + station * STATION_EEPROM), c);
+  return configValid(c);
+}
+
+// Encola el bloque entero en la escritura diferida (EepromQueue.h), que
+// solo graba los bytes que cambiaron (cada byte aguanta ~100k
+// grabaciones). false si no hay lugar en la cola: no se encoló nada.
+inline bool saveConfig(SimonConfig& c, EepromQueue& q, Instant now, uint8_t station = 0) {
+  c.magic = CONFIG_MAGIC;
+  c.version = CONFIG_VERSION;
+  c.reserved = 0;
+  c.crc = configCrc(c);
+  return q.put((uint16_t)(CONFIG_ADDR + station * STATION_EEPROM), c, now);
+}
+
+template <typename Game>
+void captureConfig(SimonConfig& c, const Game& game, const ButtonReader& buttons) {
+  for (uint8_t i = 0; i < 4; ++i) c.debounceMs[i] = (uint8_t)buttons.debounce(i);
+  c.onMs = game.timing().onMs;
+  c.offMs = game.timing().offMs;
+  c.timeoutMs = game.timing().inputTimeoutMs;
+  c.winScore = game.winScore();
+  c.colors = game.colors();
+  c.sound = game.sound() ? 1 : 0;
+}
+
+// Una grabación de la configuración pedida (menú de ajustes o consola)
+// que espera lugar en la cola: update() la reintenta en cada pasada, con
+// los valores de ese momento, así la última que se pidió es la que queda.
+class ConfigSave {
+public:
+  ConfigSave() : pending_(false) {}
+
+  void request() { pending_ = true; }
+  bool pending() const { return pending_; }
+
+  template <typename Game>
+  void update(const Game& game, const ButtonReader& buttons, EepromQueue& q, Instant now,
+              uint8_t station = 0) {
+    if (!pending_) return;
+    SimonConfig c;
+    captureConfig(c, game, buttons);
+    pending_ = !saveConfig(c, q, now, station);
+  }
+
+private:
+  bool pending_;
+};
+
+template <typename Game>
+void applyConfig(const SimonConfig& c, Game& game, ButtonReader& buttons) {
+  for (uint8_t i = 0; i < 4; ++i) buttons.setDebounce(i, c.debounceMs[i]);
+  GameTiming t = {c.onMs, c.offMs, c.timeoutMs};
+  game.setTiming(t);
+  game.setWinScore(c.winScore);
+  game.setColors(c.colors);
+  game.setSound(c.sound != 0);
+}
+
+// Estadísticas de uso: cambian en cada partida, así que van rotando entre
+// USAGE_SLOTS copias (la grabación N en la copia N % USAGE_SLOTS) y cada
+// byte se graba la cuarta parte de las veces. Al leer gana la copia válida
+// grabada última; si se corta la luz a mitad de una grabación queda la
+// anterior.
+const uint16_t USAGE_ADDR = 32;
+const uint8_t USAGE_SLOTS = 4;
+const uint8_t USAGE_MAGIC = 0x5E;
+const uint8_t USAGE_VERSION = 1;
+
+static_assert(USAGE_ADDR >= CONFIG_ADDR + sizeof(SimonConfig), "se pisa con la configuración");
+static_assert(USAGE_ADDR + USAGE_SLOTS * sizeof(UsageRecord) <= STATION_EEPROM,
+              "no entra en el lugar de una estación");
+
+inline uint16_t usageCrc(const UsageRecord& r) {
+  return crc16((const uint8_t*)&r, (uint16_t)(sizeof(r) - sizeof(r.crc)));
+}
+
+// false si no hay ninguna copia válida (stats queda como estaba)
+inline bool loadUsage(UsageStats& stats, uint8_t station = 0) {
+  UsageRecord best;
+  bool found = false;
+  for (uint8_t i = 0; i < USAGE_SLOTS; ++i) {
+    UsageRecord r;
+    EEPROM.get((int)(USAGE_ADDR + station * STATION_EEPROM + i * sizeof(UsageRecord)), r);
+    if (r.magic != USAGE_MAGIC || r.version != USAGE_VERSION || r.crc != usageCrc(r)) continue;
+    // seq da la vuelta: vale la diferencia con signo
+    if (!found || (int16_t)(r.seq - best.seq) > 0) best = r;
+    found = true;
+  }
+  if (found) stats.load(best);
+  return found;
+}
+
+// Encola la copia que sigue; false si no hay lugar en la cola (stats sigue
+// marcado y se reintenta en la próxima pasada)
+inline bool saveUsage(UsageStats& stats, EepromQueue& q, Instant now, uint8_t station = 0) {
+  UsageRecord r = stats.record();
+  r.magic = USAGE_MAGIC;
+  r.version = USAGE_VERSION;
+  r.seq = (uint16_t)(r.seq + 1);
+  r.crc = usageCrc(r);
+  uint16_t addr = (uint16_t)(USAGE_ADDR + station * STATION_EEPROM +
+                             (r.seq % USAGE_SLOTS) * sizeof(UsageRecord));
+  if (!q.put(addr, r, now)) return false;
+  stats.markSaved(r.seq);
+  return true;
+}
@@ -0,0 +1,442 @@
+#pragma once
+
+// Consola por Serial para ajustar el gabinete sin volver a grabar el
+// sketch. Una orden por línea (fin de línea \n o \r\n):
+//
+//   get [param]           valores actuales
+//   set <param> <valor>   lo cambia ya mismo
+//   save | load           graba o relee la configuración (Config.h)
+//   eeprom                cola de escritura diferida (EepromQueue.h)
+//   usage [reset]         estadísticas de uso (UsageStats.h) o borrarlas
+//   ram                   pila máxima y margen (StackPaint.h)
+//   stats                 estado del juego y uso de CPU
+//   cal                   antirrebote de cada botón
+//   bench [ms]            mide las pasadas de loop() durante ms (1000)
+//   help
+//
+// Parámetros: debounce (la ventana más larga; set pone la misma a todos los
+// botones), on, off, timeout (ms), win (puntos para ganar),
+// colors y sound (0 o 1), los mismos que el menú de ajustes.
+//
+// update() lee a lo sumo kRxBudget de los bytes que ya llegaron y arma la
+// línea en un buffer fijo, que se corta en palabras en el lugar: no usa
+// heap ni String y nunca espera al Serial. Las respuestas se arman en
+// ConsoleOut y salen de a lo que entra en el buffer de salida del Serial
+// (availableForWrite(), como VersusLink.h); la orden siguiente se lee
+// cuando salió entera la anterior. Los textos están en flash (F() y
+// PROGMEM). bench no frena el juego: abre una ventana y contesta cuando
+// termina.
+//
+// save con la cola de la EEPROM llena contesta "OK pendiente": queda
+// pedido y loop() lo reintenta (ConfigSave). load lee a través de la cola.
+
+#include <Arduino.h>
+#include "Simon.h"
+#include "Config.h"
+#include "Scheduler.h"
+#include "StackPaint.h"
+
+struct ConsoleParam {
+  char name[9];
+  uint16_t min;
+  uint16_t max;
+};
+
+const ConsoleParam CONSOLE_PARAMS[] PROGMEM = {
+  {"debounce", 0, 200},     // entra en el uint8_t de Config.h
+  {"on", 20, 5000},
+  {"off", 0, 5000},
+  {"timeout", 0, 60000},
+  {"win", 1, 99},
+  {"colors", 2, 4},
+  {"sound", 0, 1},
+};
+
+// Respuestas de la consola hasta que entran en el Serial: print() nunca
+// espera. Alcanza para la más larga (help); si no entra, se corta.
+class ConsoleOut : public Print {
+public:
+  static const uint8_t kSize = 160;
+
+  ConsoleOut() : head_(0), count_(0) {}
+
+  size_t write(uint8_t c) override {
+    if (count_ == kSize) return 0;
+    buf_[(uint8_t)((head_ + count_) % kSize)] = c;
+    ++count_;
+    return 1;
+  }
+
+  using Print::write;
+
+  bool empty() const { return count_ == 0; }
+
+  // Lo que entra sin esperar en el buffer de salida del Serial
+  void drain(HardwareSerial& io) {
+    int room = io.availableForWrite();
+    while (count_ && room-- > 0) {
+      io.write(buf_[head_]);
+      head_ = (uint8_t)((head_ + 1) % kSize);
+      --count_;
+    }
+  }
+
+private:
+  uint8_t buf_[kSize];
+  uint8_t head_;
+  uint8_t count_;
+};
+
+class SerialConsole {
+public:
+  static const uint8_t kLineMax = 32;      // con el \0
+  static const uint8_t kRxBudget = 16;     // bytes por pasada
+  static const uint8_t kParams = sizeof(CONSOLE_PARAMS) / sizeof(ConsoleParam);
+
+  SerialConsole(HardwareSerial& io, GameController& game, ButtonReader& buttons,
+                Scheduler& sched, EepromQueue& eeprom, ConfigSave& save, UsageStats& usage)
+    : io_(io), game_(game), buttons_(buttons), sched_(sched), eeprom_(eeprom),
+      save_(save), usage_(usage), len_(0),
+      overflow_(false), lines_(0), lastPassUs_(0), benching_(false),
+      benchEndMs_(0), benchStartMs_(0), benchPasses_(0), benchSumUs_(0),
+      benchMaxUs_(0) {}
+
+  void begin() {
+    lastPassUs_ = micros();
+  }
+
+  void update() {
+    update(Clock::now());
+  }
+
+  // Al final de cada pasada de loop(), con su instante. La duración de la
+  // pasada se mide aparte con micros().
+  void update(Instant now) {
+    now_ = now;
+    unsigned long us = micros();
+    if (benching_) measurePass(us - lastPassUs_);
+    lastPassUs_ = us;
+
+    // una orden por vez: la próxima cuando salió la respuesta anterior
+    for (uint8_t n = 0; n < kRxBudget && out_.empty() && io_.available() > 0; ++n) {
+      feed((char)io_.read());
+    }
+    out_.drain(io_);
+  }
+
+  uint32_t lines() const { return lines_; }
+
+private:
+  HardwareSerial& io_;
+  ConsoleOut out_;
+  GameController& game_;
+  ButtonReader& buttons_;
+  Scheduler& sched_;
+  EepromQueue& eeprom_;
+  ConfigSave& save_;
+  UsageStats& usage_;
+  char line_[kLineMax];
+  uint8_t len_;
+  bool overflow_;           // la línea no entró: se descarta entera
+  uint32_t lines_;
+  unsigned long lastPassUs_;
+  Instant now_;             // el de la pasada, para las órdenes
+  bool benching_;
+  unsigned long benchEndMs_;
+  unsigned long benchStartMs_;
+  uint32_t benchPasses_;
+  uint32_t benchSumUs_;
+  uint16_t benchMaxUs_;
+
+  void feed(char c) {
+    if (c == '\r') return;
+    if (c != '\n') {
+      if (len_ < kLineMax - 1) line_[len_++] = c;
+      else overflow_ = true;
+      return;
+    }
+    line_[len_] = '\0';
+    if (overflow_) reply(F("ERR linea larga"));
+    else if (len_) execute();
+    len_ = 0;
+    overflow_ = false;
+    ++lines_;
+  }
+
+  void execute() {
+    char* argv[3];
+    uint8_t argc = 0;
+    char* p = line_;
+    for (;;) {
+      while (*p == ' ') ++p;
+      if (!*p) break;
+      if (argc == 3) {
+        reply(F("ERR demasiados argumentos"));
+        return;
+      }
+      argv[argc++] = p;
+      while (*p && *p != ' ') ++p;
+      if (*p) *p++ = '\0';
+    }
+    if (!argc) return;
+
+    const char* cmd = argv[0];
+    if (!strcmp(cmd, "get")) cmdGet(argc > 1 ? argv[1] : nullptr);
+    else if (!strcmp(cmd, "set") && argc == 3) cmdSet(argv[1], argv[2]);
+    else if (!strcmp(cmd, "set")) reply(F("ERR uso: set <param> <valor>"));
+    else if (!strcmp(cmd, "save")) cmdSave();
+    else if (!strcmp(cmd, "load")) cmdLoad();
+    else if (!strcmp(cmd, "stats")) cmdStats();
+    else if (!strcmp(cmd, "eeprom")) cmdEeprom();
+    else if (!strcmp(cmd, "usage")) cmdUsage(argc > 1 ? argv[1] : nullptr);
+    else if (!strcmp(cmd, "ram")) cmdRam();
+    else if (!strcmp(cmd, "cal")) {
+      out_.print(F("debounce="));
+      for (uint8_t i = 0; i < 4; ++i) {
+        if (i) out_.print(',');
+        out_.print((unsigned int)buttons_.debounce(i));
+      }
+      out_.println();
+    }
+    else if (!strcmp(cmd, "bench")) cmdBench(argc > 1 ? argv[1] : nullptr);
+    else if (!strcmp(cmd, "help")) {
+      reply(F("get [p] | set p v | save | load | stats | cal | eeprom | usage [reset] | "
+              "ram | bench [ms]"));
+      out_.print(F("p: "));
+      for (uint8_t i = 0; i < kParams; ++i) {
+        out_.print(paramName(i));
+        out_.print(' ');
+      }
+      out_.println();
+    } else {
+      reply(F("ERR orden desconocida"));
+    }
+  }
+
+  void cmdGet(const char* name) {
+    if (!name) {
+      for (uint8_t i = 0; i < kParams; ++i) {
+        if (i) out_.print(' ');
+        printParam(i);
+      }
+      out_.println();
+      return;
+    }
+    int8_t id = findParam(name);
+    if (id < 0) {
+      reply(F("ERR parametro"));
+      return;
+    }
+    printParam((uint8_t)id);
+    out_.println();
+  }
+
+  void cmdSet(const char* name, const char* text) {
+    int8_t id = findParam(name);
+    uint32_t v;
+    if (id < 0) {
+      reply(F("ERR parametro"));
+      return;
+    }
+    uint16_t lo = pgm_read_word(&CONSOLE_PARAMS[id].min);
+    uint16_t hi = pgm_read_word(&CONSOLE_PARAMS[id].max);
+    if (!parseUint(text, v) || v < lo || v > hi) {
+      out_.print(F("ERR rango "));
+      out_.print((unsigned int)lo);
+      out_.print(F(".."));
+      out_.println((unsigned int)hi);
+      return;
+    }
+    setParam((uint8_t)id, (uint16_t)v);
+    out_.print(F("OK "));
+    printParam((uint8_t)id);
+    out_.println();
+  }
+
+  // Con la cola llena queda pendiente y loop() la reintenta (ConfigSave)
+  void cmdSave() {
+    save_.request();
+    save_.update(game_, buttons_, eeprom_, now_);
+    reply(save_.pending() ? F("OK pendiente") : F("OK"));
+  }
+
+  void cmdEeprom() {
+    out_.print(F("cola="));
+    out_.print((unsigned int)eeprom_.depth());
+    out_.print(F(" max="));
+    out_.print((unsigned int)eeprom_.maxDepth());
+    out_.print(F(" grabados="));
+    out_.print(eeprom_.committed());
+    out_.print(F(" iguales="));
+    out_.print(eeprom_.skipped());
+    out_.print(F(" juntados="));
+    out_.print(eeprom_.coalesced());
+    out_.print(F(" llena="));
+    out_.print(eeprom_.overflows());
+    out_.print(F(" demora="));
+    out_.print((unsigned int)eeprom_.latencyAvgMs());
+    out_.print(F("/"));
+    out_.print((unsigned int)eeprom_.latencyMaxMs());
+    out_.println(F(" ms"));
+  }
+
+  void cmdUsage(const char* arg) {
+    if (arg && strcmp(arg, "reset")) {
+      reply(F("ERR uso: usage [reset]"));
+      return;
+    }
+    if (arg) usage_.reset();
+    out_.print(F("partidas="));
+    out_.print(usage_.games());
+    out_.print(F(" ganadas="));
+    out_.print((unsigned int)usage_.winPercent());
+    out_.print(F("% nivel="));
+    uint16_t tenths = (uint16_t)(((uint32_t)usage_.levelMeanQ8() * 10 + 128) >> 8);
+    out_.print(tenths / 10);
+    out_.print('.');
+    out_.print(tenths % 10);
+    out_.print(F(" fallos="));
+    for (uint8_t i = 0; i < 4; ++i) {
+      if (i) out_.print(',');
+      out_.print((unsigned int)usage_.missed(i));
+    }
+    out_.println();
+  }
+
+  // Recorre el margen de la pila: solo a pedido
+  void cmdRam() {
+    out_.print(F("pila="));
+    out_.print((unsigned int)stackPeak());
+    out_.print(F(" libre="));
+    out_.print((unsigned int)stackHeadroom());
+#ifdef __AVR__
+    out_.print(F(" estatica="));
+    out_.print((unsigned int)staticRam());
+#endif
+    out_.println();
+  }
+
+  // A través de la cola: ve lo que se guardó aunque no esté grabado. Con
+  // un save pendiente lo que va a quedar es lo de ahora: no hay qué leer.
+  void cmdLoad() {
+    if (save_.pending()) {
+      reply(F("OK"));
+      return;
+    }
+    SimonConfig c;
+    if (!loadConfig(c, eeprom_)) {
+      reply(F("ERR no hay configuracion valida"));
+      return;
+    }
+    applyConfig(c, game_, buttons_);
+    reply(F("OK"));
+  }
+
+  void cmdStats() {
+    out_.print(F("estado="));
+    out_.print(stateName(game_.state()));
+    out_.print(F(" nivel="));
+    out_.print((unsigned int)game_.level());
+    out_.print(F(" puntos="));
+    out_.print(game_.score());
+    out_.print(F(" record="));
+    out_.print(game_.highScore());
+    out_.print(F(" cpu="));
+    out_.print((unsigned int)sched_.dutyPermille());
+    out_.print(F("/1000 lineas="));
+    out_.println(lines_);
+  }
+
+  void cmdBench(const char* text) {
+    uint32_t ms = 1000;
+    if (text && (!parseUint(text, ms) || ms == 0 || ms > 60000)) {
+      reply(F("ERR rango 1..60000"));
+      return;
+    }
+    benching_ = true;
+    benchStartMs_ = now_.ms();
+    benchEndMs_ = benchStartMs_ + ms;
+    benchPasses_ = 0;
+    benchSumUs_ = 0;
+    benchMaxUs_ = 0;
+  }
+
+  void measurePass(unsigned long us) {
+    ++benchPasses_;
+    benchSumUs_ += us;
+    if (us > benchMaxUs_) benchMaxUs_ = us > 0xFFFF ? 0xFFFF : (uint16_t)us;
+    // con otra respuesta saliendo, la ventana se alarga hasta que salga
+    if ((long)(now_.ms() - benchEndMs_) < 0 || !out_.empty()) return;
+
+    benching_ = false;
+    out_.print(F("bench: "));
+    out_.print(benchPasses_);
+    out_.print(F(" pasadas en "));
+    out_.print(now_.ms() - benchStartMs_);
+    out_.print(F(" ms, media "));
+    out_.print(benchSumUs_ / benchPasses_);
+    out_.print(F(" us, max "));
+    out_.print((unsigned int)benchMaxUs_);
+    out_.println(F(" us"));
+  }
+
+  int8_t findParam(const char* name) const {
+    for (uint8_t i = 0; i < kParams; ++i) {
+      if (!strcmp_P(name, CONSOLE_PARAMS[i].name)) return (int8_t)i;
+    }
+    return -1;
+  }
+
+  uint16_t getParam(uint8_t id) const {
+    switch (id) {
+      case 0: return buttons_.debounce();
+      case 1: return game_.timing().onMs;
+      case 2: return game_.timing().offMs;
+      case 3: return game_.timing().inputTimeoutMs;
+      case 4: return game_.winScore();
+      case 5: return game_.colors();
+      default: return game_.sound() ? 1 : 0;
+    }
+  }
+
+  void setParam(uint8_t id, uint16_t v) {
+    GameTiming t = game_.timing();
+    switch (id) {
+      case 0: buttons_.setDebounce(v); return;
+      case 1: t.onMs = v; break;
+      case 2: t.offMs = v; break;
+      case 3: t.inputTimeoutMs = v; break;
+      case 4: game_.setWinScore((uint8_t)v); return;
+      case 5: game_.setColors((uint8_t)v); return;
+      default: game_.setSound(v != 0); return;
+    }
+    game_.setTiming(t);
+  }
+
+  void printParam(uint8_t id) {
+    out_.print(paramName(id));
+    out_.print('=');
+    out_.print((unsigned int)getParam(id));
+  }
+
+  static const __FlashStringHelper* paramName(uint8_t id) {
+    return (const __FlashStringHelper*)CONSOLE_PARAMS[id].name;
+  }
+
+  void reply(const __FlashStringHelper* s) {
+    out_.print(s);
+    out_.println();
+  }
+
+  // Solo dígitos decimales, hasta 5
+  static bool parseUint(const char* s, uint32_t& out) {
+    uint32_t v = 0;
+    uint8_t n = 0;
+    for (; *s; ++s, ++n) {
+      if (*s < '0' || *s > '9' || n == 5) return false;
+      v = v * 10 + (uint32_t)(*s - '0');
+    }
+    out = v;
+    return n > 0;
+  }
+};
@@ -0,0 +1,115 @@
+#pragma once
+
+// Dificultad adaptativa: ajusta la velocidad del patrón y los puntos para
+// ganar según cómo viene jugando la persona, para que complete más o menos
+// `target` de las rondas sin importar si es novata o experta.
+//
+// Lleva medias móviles exponenciales (alfa = 1/8) del tiempo de reacción,
+// de las rondas completadas y de en qué parte de la secuencia se equivoca,
+// y del nivel al que llega en cada partida. Todo en punto fijo con enteros
+// y memoria constante; se recalcula solo entre rondas.
+//
+// Velocidad: speed_ en Q8 (256 = tiempos base). Si completa más rondas que
+// el objetivo se acelera y si completa menos se frena, en proporción a la
+// diferencia. Cuando los errores caen casi siempre al final de la
+// secuencia el problema es la memoria y no la velocidad: frena la mitad.
+// El paso nunca dura menos que la mitad del tiempo de reacción medio.
+// Puntos para ganar: dos más que el nivel al que suele llegar.
+
+#include <Arduino.h>
+#include "GameTiming.h"
+
+class AdaptiveDifficulty {
+public:
+  static const uint16_t kSpeedMin = 128;      // mitad de velocidad
+  static const uint16_t kSpeedMax = 1024;     // cuatro veces más rápido
+  static const uint16_t kOnMinMs = 80;
+  static const uint16_t kOffMinMs = 40;
+  static const uint8_t kWinMin = 3;
+  static const uint8_t kWinMax = 40;
+
+  AdaptiveDifficulty(const GameTiming& base, uint16_t targetPermille = 700)
+    : base_(base), target_((uint16_t)((uint32_t)targetPermille * 4096 / 1000)) {
+    reset();
+  }
+
+  // Sesión nueva (otra persona)
+  void reset() {
+    speed_ = 256;
+    success_ = target_;
+    reactionQ4_ = 0;
+    errorPos_ = 128;
+    levelQ8_ = (uint16_t)(kWinMin - 2) << 8;
+    rounds_ = 0;
+  }
+
+  // Cada botón correcto: ms desde el fin del patrón o desde el botón anterior
+  void press(unsigned long reactionMs) {
+    uint16_t r = reactionMs > 4000 ? 4000 : (uint16_t)reactionMs;
+    if (reactionQ4_ == 0) reactionQ4_ = (uint16_t)(r << 4);
+    else reactionQ4_ = (uint16_t)(reactionQ4_ + (((int32_t)(r << 4) - reactionQ4_) >> 3));
+  }
+
+  // Fin de ronda; si falló, errorPos = índice de la respuesta equivocada
+  void roundEnd(bool ok, uint8_t errorPos, uint8_t len) {
+    ++rounds_;
+    int32_t sample = ok ? 4096 : 0;
+    success_ = (uint16_t)(success_ + ((sample - success_) >> 3));
+    if (!ok && len) {
+      int32_t pos = (int32_t)errorPos * 256 / len;
+      errorPos_ = (uint16_t)(errorPos_ + ((pos - errorPos_) >> 3));
+    }
+
+    // 1/64 de la diferencia con el objetivo por ronda: a lo sumo ±0.25x
+    int32_t delta = ((int32_t)success_ - target_) / 64;
+    if (delta < 0 && errorPos_ >= 192) delta /= 2;
+    int32_t s = (int32_t)speed_ + delta;
+    if (s < kSpeedMin) s = kSpeedMin;
+    if (s > kSpeedMax) s = kSpeedMax;
+    speed_ = (uint16_t)s;
+  }
+
+  // Fin de partida con el nivel alcanzado
+  void gameEnd(uint8_t level) {
+    levelQ8_ = (uint16_t)(levelQ8_ + (((int32_t)level << 8) - levelQ8_) / 8);
+  }
+
+  // Nunca muestra cada paso por menos de la mitad de lo que tarda en
+  // reaccionar: más rápido que eso ya no lo llega a ver
+  GameTiming timing() const {
+    GameTiming t = base_;
+    uint16_t onMin = reactionMs() / 2;
+    t.onMs = scale(base_.onMs, onMin > kOnMinMs ? onMin : kOnMinMs);
+    t.offMs = scale(base_.offMs, kOffMinMs);
+    return t;
+  }
+
+  uint8_t winScore() const {
+    uint16_t w = (uint16_t)((levelQ8_ + 128) >> 8) + 2;
+    if (w < kWinMin) w = kWinMin;
+    if (w > kWinMax) w = kWinMax;
+    return (uint8_t)w;
+  }
+
+  // Lecturas para depurar y medir
+  uint16_t speedQ8() const { return speed_; }
+  uint16_t successPermille() const { return (uint16_t)((uint32_t)success_ * 1000 / 4096); }
+  uint16_t reactionMs() const { return (uint16_t)(reactionQ4_ >> 4); }
+  uint16_t errorPosPermille() const { return (uint16_t)((uint32_t)errorPos_ * 1000 / 256); }
+  uint32_t rounds() const { return rounds_; }
+
+private:
+  GameTiming base_;
+  uint16_t target_;       // Q12
+  uint16_t speed_;        // Q8
+  uint16_t success_;      // Q12, rondas completadas
+  uint16_t reactionQ4_;   // ms en Q4; 0 = sin datos
+  uint16_t errorPos_;     // Q8, 0 = primer paso, 256 = último
+  uint16_t levelQ8_;      // nivel alcanzado por partida
+  uint32_t rounds_;
+
+  uint16_t scale(uint16_t ms, uint16_t minMs) const {
+    uint32_t v = ((uint32_t)ms << 8) / speed_;
+    return v < minMs ? minMs : (uint16_t)v;
+  }
+};
@@ -0,0 +1,206 @@
+#pragma once
+
+// Escritura diferida a la EEPROM. Grabar un byte tarda ~3.3 ms y
+// EEPROM.write() espera a que termine el anterior, así que guardar un
+// bloque desde loop() frenaría el juego. put() solo anota la escritura en
+// una cola en RAM y vuelve; la interrupción EE_READY (la EEPROM quedó
+// libre) graba de a un byte por vez hasta vaciarla.
+//
+//   - Si la dirección ya está en la cola se pisa el valor (se juntan).
+//   - Antes de grabar, service() lee el byte: si ya tiene ese valor lo
+//     saltea y sigue con el próximo, sin gastar una grabación.
+//
+// put() corre con las interrupciones apagadas mientras busca y encola
+// (a lo sumo kSize entradas) y después las deja como estaban: se puede
+// llamar con las interrupciones ya apagadas. En el AVR el sketch engancha
+// service() a ISR(EE_READY_vect); en la PC lo llama el simulador cuando la
+// EEPROM queda libre (eepromSetReadyIsr).
+
+#include <Arduino.h>
+#include <EEPROM.h>
+#include "TimeBase.h"
+
+#ifdef __AVR__
+#include <avr/io.h>
+
+inline uint8_t eepromReadNow(uint16_t addr) {
+  EEAR = addr;
+  EECR |= _BV(EERE);
+  return EEDR;
+}
+
+// Solo con la EEPROM libre (EEPE en 0), como dentro de EE_READY
+inline void eepromStartWrite(uint16_t addr, uint8_t value) {
+  EEAR = addr;
+  EEDR = value;
+  EECR |= _BV(EEMPE);
+  EECR |= _BV(EEPE);
+}
+
+inline void eepromReadyInterrupt(bool on) {
+  if (on) EECR |= _BV(EERIE);
+  else EECR &= (uint8_t)~_BV(EERIE);
+}
+
+// Hasta que termine la grabación en curso (mientras tanto no se lee)
+inline void eepromWaitIdle() {
+  while (EECR & _BV(EEPE)) {}
+}
+#endif
+
+class EepromQueue {
+public:
+  static const uint8_t kSize = 32;
+
+  EepromQueue()
+    : head_(0), count_(0), maxDepth_(0), committed_(0), skipped_(0),
+      coalesced_(0), overflows_(0), latencySumMs_(0), latencyMaxMs_(0) {}
+
+  // false si la cola está llena (no se anotó nada)
+  bool put(uint16_t addr, uint8_t value) {
+    return put(addr, value, Clock::now());
+  }
+
+  // Con el instante de la pasada (para la demora hasta grabarse)
+  bool put(uint16_t addr, uint8_t value, Instant now) {
+    uint8_t sreg = lock();
+    for (uint8_t n = 0; n < count_; ++n) {
+      Entry& e = slot_[(uint8_t)(head_ + n) % kSize];
+      if (e.addr == addr) {
+        e.value = value;
+        ++coalesced_;
+        unlock(sreg);
+        return true;
+      }
+    }
+    if (count_ == kSize) {
+      ++overflows_;
+      unlock(sreg);
+      return false;
+    }
+    Entry& e = slot_[(uint8_t)(head_ + count_) % kSize];
+    e.addr = addr;
+    e.value = value;
+    e.queuedMs = (uint16_t)now.ms();
+    count_ = (uint8_t)(count_ + 1);
+    if (count_ > maxDepth_) maxDepth_ = count_;
+    eepromReadyInterrupt(true);
+    unlock(sreg);
+    return true;
+  }
+
+  template <typename T>
+  bool put(uint16_t addr, const T& t) {
+    return put(addr, t, Clock::now());
+  }
+
+  template <typename T>
+  bool put(uint16_t addr, const T& t, Instant now) {
+    if (room() < sizeof(T)) return false;
+    const uint8_t* p = (const uint8_t*)&t;
+    for (uint16_t i = 0; i < sizeof(T); ++i) put((uint16_t)(addr + i), p[i], now);
+    return true;
+  }
+
+  // Un byte como va a quedar: el valor encolado si la dirección está en la
+  // cola y si no el de la EEPROM. Para leer se apaga EE_READY, así la ISR
+  // no cambia EEAR ni arranca otra grabación en el medio; se espera como
+  // mucho la grabación en curso, con las demás interrupciones prendidas.
+  uint8_t read(uint16_t addr) {
+    uint8_t sreg = lock();
+    for (uint8_t n = 0; n < count_; ++n) {
+      const Entry& e = slot_[(uint8_t)(head_ + n) % kSize];
+      if (e.addr == addr) {
+        uint8_t v = e.value;
+        unlock(sreg);
+        return v;
+      }
+    }
+    eepromReadyInterrupt(false);
+    unlock(sreg);
+    eepromWaitIdle();
+    sreg = lock();
+    uint8_t v = eepromReadNow(addr);
+    if (count_) eepromReadyInterrupt(true);
+    unlock(sreg);
+    return v;
+  }
+
+  // Como EEPROM.get(), pero viendo lo que todavía está en la cola
+  template <typename T>
+  T& get(uint16_t addr, T& t) {
+    uint8_t* p = (uint8_t*)&t;
+    for (uint16_t i = 0; i < sizeof(T); ++i) p[i] = read((uint16_t)(addr + i));
+    return t;
+  }
+
+  // Cuerpo de ISR(EE_READY_vect): graba la próxima entrada que cambie algo
+  void service() {
+    while (count_) {
+      Entry e = slot_[head_];
+      head_ = (uint8_t)((head_ + 1) % kSize);
+      count_ = (uint8_t)(count_ - 1);
+      uint16_t waited = (uint16_t)((uint16_t)millis() - e.queuedMs);
+      latencySumMs_ += waited;
+      if (waited > latencyMaxMs_) latencyMaxMs_ = waited;
+      if (eepromReadNow(e.addr) == e.value) {
+        ++skipped_;
+        continue;
+      }
+      eepromStartWrite(e.addr, e.value);
+      ++committed_;
+      return;
+    }
+    eepromReadyInterrupt(false);
+  }
+
+  uint8_t depth() const { return count_; }
+  uint8_t room() const { return (uint8_t)(kSize - count_); }
+  bool idle() const { return count_ == 0; }
+
+  // Métricas desde el arranque
+  uint8_t maxDepth() const { return maxDepth_; }
+  uint32_t committed() const { return committed_; }
+  uint32_t skipped() const { return skipped_; }
+  uint32_t coalesced() const { return coalesced_; }
+  uint32_t overflows() const { return overflows_; }
+  uint16_t latencyMaxMs() const { return latencyMaxMs_; }
+
+  // Demora media desde put() hasta grabarse (o saltearse), en ms
+  uint16_t latencyAvgMs() const {
+    uint32_t n = committed_ + skipped_;
+    return n ? (uint16_t)(latencySumMs_ / n) : 0;
+  }
+
+private:
+  struct Entry {
+    uint16_t addr;
+    uint8_t value;
+    uint16_t queuedMs;        // cuándo entró (la primera vez, si se juntó)
+  };
+
+  Entry slot_[kSize];
+  volatile uint8_t head_;
+  volatile uint8_t count_;
+  uint8_t maxDepth_;
+  uint32_t committed_;
+  uint32_t skipped_;
+  uint32_t coalesced_;
+  uint32_t overflows_;
+  uint32_t latencySumMs_;
+  uint16_t latencyMaxMs_;
+
+  // Apaga las interrupciones; unlock() vuelve a dejar SREG como estaba
+#ifdef __AVR__
+  static uint8_t lock() {
+    uint8_t sreg = SREG;
+    cli();
+    return sreg;
+  }
+
+  static void unlock(uint8_t sreg) { SREG = sreg; }
+#else
+  static uint8_t lock() { return 0; }
+  static void unlock(uint8_t) {}
+#endif
+};
@@ -0,0 +1,275 @@
+#pragma once
+
+// Grabación y reproducción de partidas.
+// Se guarda la semilla del patrón y cada cambio crudo de los botones (antes
+// del antirrebote) con su tiempo. Con eso el GameController repite la misma
+// partida: mismo patrón, mismas transiciones, en el Arduino o en la PC.
+//
+// Formato de una grabación (little endian):
+//   0   'S' 'R' versión
+//   3   semilla del patrón (4 bytes)
+//   7   niveles de los botones en el toque que arranca la partida (bit i =
+//       botón i en HIGH); ese toque es el tiempo 0 de los eventos
+//   8   largo de los eventos en bytes (2 bytes)
+//   10  resultado: bit 7 = ganó, bits 0..6 = puntaje
+//   11  marcas: bit 0 = cortada (no entró en el buffer; no se reproduce)
+//   12  eventos: varint de (ms desde el evento anterior << 4 | niveles)
+//
+// Un toque de botón son dos eventos de 2 bytes; el rebote de un contacto
+// suma eventos de 1 byte.
+
+#include <Arduino.h>
+
+const uint8_t REC_VERSION = 3;
+const uint8_t REC_HEADER = 12;
+const uint8_t REC_TRUNCATED = 0x01;
+
+class InputRecorder {
+public:
+  InputRecorder(uint8_t* buf, uint16_t capacity)
+    : buf_(buf), capacity_(capacity), len_(0), levels_(0x0F),
+      lastMs_(0), recording_(false), truncated_(false), finished_(false) {}
+
+  // Cada pasada de loop(), con los niveles crudos de los botones
+  void sample(uint8_t levels, unsigned long now) {
+    if (recording_ && levels != levels_) {
+      uint32_t v = ((uint32_t)(now - lastMs_) << 4) | (levels & 0x0F);
+      lastMs_ = now;
+      if (!putVarint(v)) truncated_ = true;
+    }
+    levels_ = levels;
+  }
+
+  // En el toque que va a arrancar la partida (ya está en levels_). La
+  // partida empieza kChordMs después y lo que pase mientras (soltar el
+  // botón) ya se graba.
+  void arm(unsigned long now) {
+    if (capacity_ < REC_HEADER) return;
+    buf_[0] = 'S';
+    buf_[1] = 'R';
+    buf_[2] = REC_VERSION;
+    for (uint8_t i = 0; i < 4; ++i) buf_[3 + i] = 0;
+    buf_[7] = levels_;
+    buf_[10] = 0;
+    buf_[11] = 0;
+    len_ = REC_HEADER;
+    lastMs_ = now;
+    recording_ = true;
+    truncated_ = false;
+    finished_ = false;
+  }
+
+  // El toque no arrancó una partida (se formó un acorde)
+  void cancel() {
+    recording_ = false;
+  }
+
+  // Al empezar la partida; sin arm() antes (startGame()), el tiempo 0 es
+  // este
+  void beginGame(uint32_t seed, unsigned long now) {
+    if (!recording_) arm(now);
+    if (!recording_) return;
+    for (uint8_t i = 0; i < 4; ++i) buf_[3 + i] = (uint8_t)(seed >> (8 * i));
+  }
+
+  void endGame(bool won, uint8_t score) {
+    if (!recording_) return;
+    uint16_t events = len_ - REC_HEADER;
+    buf_[8] = (uint8_t)events;
+    buf_[9] = (uint8_t)(events >> 8);
+    buf_[10] = (uint8_t)((won ? 0x80 : 0) | (score & 0x7F));
+    buf_[11] = truncated_ ? REC_TRUNCATED : 0;
+    recording_ = false;
+    finished_ = true;
+  }
+
+  // true una sola vez por partida terminada (para mandarla por Serial, etc.)
+  bool takeFinished() {
+    bool f = finished_;
+    finished_ = false;
+    return f;
+  }
+
+  bool recording() const { return recording_; }
+  bool truncated() const { return truncated_; }
+  const uint8_t* data() const { return buf_; }
+  uint16_t size() const { return len_; }
+
+private:
+  uint8_t* buf_;
+  uint16_t capacity_;
+  uint16_t len_;
+  uint8_t levels_;
+  unsigned long lastMs_;
+  bool recording_;
+  bool truncated_;
+  bool finished_;
+
+  bool putVarint(uint32_t v) {
+    // si no entra completo no se escribe nada: la grabación queda cortada
+    uint8_t tmp[5];
+    uint8_t n = 0;
+    do {
+      uint8_t b = v & 0x7F;
+      v >>= 7;
+      tmp[n++] = v ? (uint8_t)(b | 0x80) : b;
+    } while (v);
+    if (truncated_ || len_ + n > capacity_) return false;
+    for (uint8_t i = 0; i < n; ++i) buf_[len_++] = tmp[i];
+    return true;
+  }
+};
+
+class InputReplay {
+public:
+  InputReplay() : data_(nullptr), end_(0), pos_(0), levels_(0x0F),
+                  nextMs_(0), nextLevels_(0), hasNext_(false), started_(false) {}
+
+  // Valida la cabecera; data tiene que seguir viva durante la reproducción.
+  // Una grabación cortada no se carga: le falta el final de la partida.
+  bool load(const uint8_t* data, uint16_t len) {
+    data_ = nullptr;
+    if (len < REC_HEADER || data[0] != 'S' || data[1] != 'R' ||
+        data[2] != REC_VERSION || (data[11] & REC_TRUNCATED)) {
+      return false;
+    }
+    uint16_t events = (uint16_t)(data[8] | (data[9] << 8));
+    if (REC_HEADER + events > len) return false;
+    data_ = data;
+    end_ = REC_HEADER + events;
+    pos_ = REC_HEADER;
+    levels_ = data[7];
+    hasNext_ = false;
+    started_ = false;
+    return true;
+  }
+
+  bool loaded() const { return data_ != nullptr; }
+
+  uint32_t seed() const {
+    return (uint32_t)data_[3] | ((uint32_t)data_[4] << 8) |
+           ((uint32_t)data_[5] << 16) | ((uint32_t)data_[6] << 24);
+  }
+
+  bool won() const { return data_[10] & 0x80; }
+  uint8_t score() const { return data_[10] & 0x7F; }
+  uint16_t size() const { return end_; }
+
+  // Tiempo 0 de los eventos: la pasada del toque que arranca la partida
+  void beginGame(unsigned long now) {
+    started_ = true;
+    nextMs_ = now;
+    hasNext_ = readNext();
+  }
+
+  // Niveles crudos de los botones a esta hora
+  uint8_t levels(unsigned long now) {
+    while (started_ && hasNext_ && (long)(now - nextMs_) >= 0) {
+      levels_ = nextLevels_;
+      hasNext_ = readNext();
+    }
+    return levels_;
+  }
+
+  bool started() const { return started_; }
+  bool finished() const { return started_ && !hasNext_; }
+
+  // Hora del último evento (cuando finished())
+  unsigned long endMs() const { return nextMs_; }
+
+private:
+  const uint8_t* data_;
+  uint16_t end_;
+  uint16_t pos_;
+  uint8_t levels_;
+  unsigned long nextMs_;
+  uint8_t nextLevels_;
+  bool hasNext_;
+  bool started_;
+
+  bool readNext() {
+    uint32_t v = 0;
+    uint8_t shift = 0;
+    while (pos_ < end_) {
+      // un varint de 32 bits tiene a lo sumo 5 bytes: lo demás es basura
+      if (shift > 28) {
+        pos_ = end_;
+        return false;
+      }
+      uint8_t b = data_[pos_++];
+      v |= (uint32_t)(b & 0x7F) << shift;
+      shift += 7;
+      if (!(b & 0x80)) {
+        nextMs_ += v >> 4;
+        nextLevels_ = (uint8_t)(v & 0x0F);
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
+// Las grabaciones viajan por Serial como una línea "REC <hex>".
+inline void printRecording(Print& out, const uint8_t* data, uint16_t len) {
+  static const char hex[] = "0123456789ABCDEF";
+  out.print("REC ");
+  for (uint16_t i = 0; i < len; ++i) {
+    out.print(hex[data[i] >> 4]);
+    out.print(hex[data[i] & 0x0F]);
+  }
+  out.println();
+}
+
+// Arma una grabación a partir de líneas "REC <hex>", de a un carácter,
+// sin bloquear. feed() devuelve true cuando completó una.
+class RecordingLineReader {
+public:
+  RecordingLineReader(uint8_t* buf, uint16_t capacity)
+    : buf_(buf), capacity_(capacity), len_(0), size_(0), prefix_(0),
+      nibble_(0xFF), bad_(false) {}
+
+  bool feed(char c) {
+    static const char tag[] = "REC ";
+    if (c == '\r') return false;
+    if (c == '\n') {
+      bool ok = prefix_ == 4 && !bad_ && nibble_ == 0xFF && len_ >= REC_HEADER;
+      size_ = ok ? len_ : 0;
+      len_ = 0;
+      prefix_ = 0;
+      nibble_ = 0xFF;
+      bad_ = false;
+      return ok;
+    }
+    if (bad_) return false;
+    if (prefix_ < 4) {
+      if (c == tag[prefix_]) ++prefix_; else bad_ = true;
+      return false;
+    }
+    uint8_t v;
+    if (c >= '0' && c <= '9') v = (uint8_t)(c - '0');
+    else if (c >= 'A' && c <= 'F') v = (uint8_t)(c - 'A' + 10);
+    else if (c >= 'a' && c <= 'f') v = (uint8_t)(c - 'a' + 10);
+    else { bad_ = true; return false; }
+    if (nibble_ == 0xFF) {
+      nibble_ = v;
+    } else if (len_ < capacity_) {
+      buf_[len_++] = (uint8_t)((nibble_ << 4) | v);
+      nibble_ = 0xFF;
+    } else {
+      bad_ = true;
+    }
+    return false;
+  }
+
+  const uint8_t* data() const { return buf_; }
+  uint16_t size() const { return size_; }
+
+private:
+  uint8_t* buf_;
+  uint16_t capacity_;
+  uint16_t len_;
+  uint16_t size_;
+  uint8_t prefix_;
+  uint8_t nibble_;
+  bool bad_;
+};
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Tiempos del juego (ms)
+struct GameTiming {
+  uint16_t onMs;            // LED encendido al mostrar cada paso
+  uint16_t offMs;           // pausa entre pasos
+  uint16_t inputTimeoutMs;  // espera máxima por cada botón; 0 = sin límite
+};
+
+const GameTiming DEFAULT_TIMING = {400, 200, 0};
@@ -0,0 +1,78 @@
+#pragma once
+
+// Hot seat: de 2 a MAX_PLAYERS jugadores se turnan en el mismo tablero,
+// una ronda cada uno. Con `shared` (compilar con SIMON_HOTSEAT_SHARED)
+// todos repiten el mismo patrón; si no, cada uno tiene el suyo.
+//
+// Todo el estado por jugador vive en un arreglo fijo (nada de heap) y el
+// patrón de cada turno se regenera desde la semilla del jugador, así que
+// un jugador más cuesta sizeof(PlayerSlot) bytes y no un patrón entero.
+// Compilar con -DSIMON_SIZE_REPORT para ver los tamaños (SizeReport.h).
+
+#include <Arduino.h>
+#include "SizeReport.h"
+
+#ifndef SIMON_MAX_PLAYERS
+#define SIMON_MAX_PLAYERS 4
+#endif
+
+const uint8_t MAX_PLAYERS = SIMON_MAX_PLAYERS;
+
+struct PlayerSlot {
+  uint32_t seed;    // semilla de su patrón
+  uint8_t level;    // largo de la ronda que le toca
+  uint8_t score;    // última ronda que completó
+  bool out;         // ya perdió
+};
+
+struct PlayerArena {
+  PlayerSlot slot[MAX_PLAYERS];
+  uint8_t count;    // jugadores en esta partida; 1 = juego clásico
+  uint8_t turn;
+  bool shared;      // todos con el mismo patrón
+
+  PlayerArena() : count(1), turn(0), shared(false) {}
+
+  void start(uint32_t seed, uint8_t players) {
+    count = players > MAX_PLAYERS ? MAX_PLAYERS : players;
+    turn = 0;
+    for (uint8_t i = 0; i < count; ++i) {
+      uint32_t s = shared ? seed : seed + i * 0x9E3779B9UL;
+      slot[i].seed = s ? s : 1;
+      slot[i].level = 1;
+      slot[i].score = 0;
+      slot[i].out = false;
+    }
+  }
+
+  bool active() const {
+    return count > 1;
+  }
+
+  // Pasa al próximo jugador que sigue en carrera (puede ser el mismo);
+  // false si ya perdieron todos
+  bool advance() {
+    for (uint8_t k = 1; k <= count; ++k) {
+      uint8_t j = (uint8_t)((turn + k) % count);
+      if (!slot[j].out) {
+        turn = j;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // El de más puntos (el primero si empatan)
+  uint8_t best() const {
+    uint8_t b = 0;
+    for (uint8_t i = 1; i < count; ++i) {
+      if (slot[i].score > slot[b].score) b = i;
+    }
+    return b;
+  }
+};
+
+SIMON_REPORT_SIZE(PlayerSlot);
+SIMON_REPORT_SIZE(PlayerArena);
+static_assert(sizeof(PlayerArena) <= 8 * MAX_PLAYERS + 4,
+              "PlayerArena creció: revisar el costo por jugador");
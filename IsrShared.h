@@ -0,0 +1,233 @@
+#pragma once
+
+// Comunicación entre loop() y las interrupciones sin apagarlas (o
+// apagándolas unos pocos ciclos). Tres piezas:
+//
+//   IsrRing<T, N>   cola de un productor y un consumidor: uno escribe (la
+//                   ISR, por ejemplo los flancos de un botón) y el otro lee
+//                   (loop()), o al revés (notas para el buzzer). Cada índice
+//                   lo escribe uno solo, así que no hace falta cli().
+//   IsrFlags        ocho banderas que se prenden desde cualquier lado y
+//                   take() lee y apaga juntas ("pasó algo desde la última
+//                   vez"; varias veces seguidas cuentan como una).
+//   IsrSnapshot<T>  el último valor de algo que escribe una ISR (contadores
+//                   de ticks, un estado de varios bytes) leído entero desde
+//                   loop() con un seqlock: si la ISR escribió durante la
+//                   copia, se vuelve a copiar.
+//
+// En el AVR los índices y la secuencia son de un byte (se leen y escriben
+// en una instrucción) y alcanza con barreras del compilador. En la PC son
+// std::atomic, así el simulador y simon_isr_stress (hilos en lugar de
+// interrupciones) siguen el mismo modelo de memoria.
+//
+// Ciclos en el ATmega328P: son ESTIMACIONES, no mediciones. No hay
+// compilación para el AVR en este repositorio; se contaron a mano sobre
+// las instrucciones que se espera de avr-gcc -Os (objetos globales, sin
+// la llamada si no se inlinea). Sirven para comparar las operaciones
+// entre sí; para el número real, avr-objdump -d sobre el sketch compilado.
+//
+//   IsrRing<uint8_t,16>::push / pop     ~18   (lleno/vacío: ~9)
+//   IsrFlags::set                        ~8   (3 con las interrupciones apagadas)
+//   IsrFlags::take                      ~11
+//   IsrSnapshot<uint32_t>::write        ~26   (dentro de la ISR)
+//   IsrSnapshot<uint32_t>::read         ~18   (+18 por cada reintento)
+
+#include <Arduino.h>
+
+#ifdef __AVR__
+// Que el compilador no mueva lecturas ni escrituras de memoria de un lado
+// al otro (el AVR no reordena por su cuenta)
+#define ISR_BARRIER() __asm__ __volatile__("" ::: "memory")
+#else
+#include <atomic>
+#endif
+
+// Un byte compartido con una ISR: store() publica lo escrito antes y load()
+// ve lo que se publicó
+class IsrByte {
+public:
+  IsrByte() : v_(0) {}
+
+#ifdef __AVR__
+  uint8_t load() const {
+    uint8_t v = v_;
+    ISR_BARRIER();
+    return v;
+  }
+
+  void store(uint8_t v) {
+    ISR_BARRIER();
+    v_ = v;
+  }
+
+  // Sin orden: para leer lo que escribió uno mismo, o después de una
+  // barrera
+  uint8_t relaxed() const { return v_; }
+
+private:
+  volatile uint8_t v_;
+#else
+  uint8_t load() const { return v_.load(std::memory_order_acquire); }
+  void store(uint8_t v) { v_.store(v, std::memory_order_release); }
+  uint8_t relaxed() const { return v_.load(std::memory_order_relaxed); }
+
+private:
+  std::atomic<uint8_t> v_;
+#endif
+};
+
+// N potencia de 2 hasta 128: los índices corren libres en un byte y
+// (head - tail) es cuántos hay, aun después de dar la vuelta
+template <typename T, uint8_t N>
+class IsrRing {
+public:
+  static_assert(N >= 2 && N <= 128 && (N & (N - 1)) == 0,
+                "N tiene que ser potencia de 2 y a lo sumo 128");
+
+  // Solo el productor. false si está llena (no se anotó nada)
+  bool push(const T& v) {
+    uint8_t h = head_.relaxed();
+    if ((uint8_t)(h - tail_.load()) == N) return false;
+    slot_[h & (N - 1)] = v;
+    head_.store((uint8_t)(h + 1));
+    return true;
+  }
+
+  // Solo el consumidor. false si está vacía
+  bool pop(T& v) {
+    uint8_t t = tail_.relaxed();
+    if (head_.load() == t) return false;
+    v = slot_[t & (N - 1)];
+    tail_.store((uint8_t)(t + 1));
+    return true;
+  }
+
+  // Solo el consumidor: el próximo, sin sacarlo. false si está vacía
+  bool peek(T& v) const {
+    uint8_t t = tail_.relaxed();
+    if (head_.load() == t) return false;
+    v = slot_[t & (N - 1)];
+    return true;
+  }
+
+  // Desde cualquiera de los dos lados; el otro puede cambiarlo enseguida
+  uint8_t size() const { return (uint8_t)(head_.load() - tail_.load()); }
+  bool empty() const { return size() == 0; }
+  static uint8_t capacity() { return N; }
+
+private:
+  T slot_[N];
+  IsrByte head_;            // lo escribe solo el productor
+  IsrByte tail_;            // lo escribe solo el consumidor
+};
+
+class IsrFlags {
+public:
+  IsrFlags() : bits_(0) {}
+
+  // Desde loop() o desde una ISR
+  void set(uint8_t mask) {
+#ifdef __AVR__
+    uint8_t sreg = SREG;
+    cli();
+    bits_ |= mask;
+    SREG = sreg;
+#else
+    bits_.fetch_or(mask, std::memory_order_release);
+#endif
+  }
+
+  // Las de mask que estaban prendidas; quedan apagadas
+  uint8_t take(uint8_t mask = 0xFF) {
+#ifdef __AVR__
+    uint8_t sreg = SREG;
+    cli();
+    uint8_t got = (uint8_t)(bits_ & mask);
+    bits_ &= (uint8_t)~got;
+    SREG = sreg;
+    return got;
+#else
+    return (uint8_t)(bits_.fetch_and((uint8_t)~mask, std::memory_order_acquire) & mask);
+#endif
+  }
+
+  // Sin apagarlas
+  uint8_t peek() const {
+#ifdef __AVR__
+    return bits_;
+#else
+    return bits_.load(std::memory_order_acquire);
+#endif
+  }
+
+private:
+#ifdef __AVR__
+  volatile uint8_t bits_;
+#else
+  std::atomic<uint8_t> bits_;
+#endif
+};
+
+// Un escritor que el lector no puede interrumpir (la ISR; en la PC, un
+// hilo) y lectores en loop(). La secuencia es impar mientras se escribe;
+// es de un byte, así que la copia no puede tardar 128 escrituras.
+// T se copia byte a byte: tiene que poder copiarse con memcpy.
+template <typename T>
+class IsrSnapshot {
+public:
+  static_assert(sizeof(T) < 256, "para bloques chicos");
+
+  IsrSnapshot() {
+    T zero;
+    memset(&zero, 0, sizeof(T));
+    write(zero);
+  }
+
+  void write(const T& v) {
+    uint8_t s = seq_.relaxed();
+    const uint8_t* p = (const uint8_t*)&v;
+    seq_.store((uint8_t)(s + 1));
+#ifdef __AVR__
+    ISR_BARRIER();
+    for (uint8_t i = 0; i < sizeof(T); ++i) data_[i] = p[i];
+#else
+    std::atomic_thread_fence(std::memory_order_release);
+    for (uint8_t i = 0; i < sizeof(T); ++i) data_[i].store(p[i], std::memory_order_relaxed);
+#endif
+    seq_.store((uint8_t)(s + 2));
+  }
+
+  // Devuelve cuántas veces tuvo que volver a copiar
+  uint8_t read(T& v) const {
+    uint8_t* p = (uint8_t*)&v;
+    uint8_t retries = 0;
+    for (;;) {
+      uint8_t s = seq_.load();
+      if (!(s & 1)) {
+#ifdef __AVR__
+        for (uint8_t i = 0; i < sizeof(T); ++i) p[i] = data_[i];
+        ISR_BARRIER();
+#else
+        for (uint8_t i = 0; i < sizeof(T); ++i) p[i] = data_[i].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+#endif
+        if (seq_.relaxed() == s) return retries;
+      }
+      if (retries < 0xFF) ++retries;
+    }
+  }
+
+  T read() const {
+    T v;
+    read(v);
+    return v;
+  }
+
+private:
+  IsrByte seq_;
+#ifdef __AVR__
+  uint8_t data_[sizeof(T)];
+#else
+  std::atomic<uint8_t> data_[sizeof(T)];
+#endif
+};
@@ -0,0 +1,134 @@
+#pragma once
+
+// LCD sin bloquear para las estaciones (Stations.h): los mismos métodos
+// que usa DisplayLCD, pero escriben en una copia de la DDRAM del HD44780
+// (2 líneas de 40) y flush() manda al LCD a lo sumo kTransfersPerPass
+// transferencias por pasada, solo de las celdas que cambiaron. Una
+// pantalla entera (clear() y 32 caracteres) cuesta ~7 ms de bus con
+// LiquidCrystal; así se reparte en pasadas de menos de 1 ms y las demás
+// estaciones no esperan.
+//
+// clear() no manda el comando (1.5 ms): deja la copia en blanco y se
+// borran solo las celdas que tenían algo. El corrimiento de la
+// marquesina se manda antes que los caracteres, un paso por transferencia
+// para el lado más corto (home() también tardaría 1.5 ms).
+
+#include <Arduino.h>
+#include <LiquidCrystal.h>
+
+class LcdBuffer : public Print {
+public:
+  static const uint8_t kLineLen = 40;
+  static const uint8_t kLines = 2;
+  static const uint8_t kTransfersPerPass = 4;
+
+  explicit LcdBuffer(LiquidCrystal& lcd) : lcd_(lcd) {
+    reset();
+  }
+
+  void begin(uint8_t cols, uint8_t rows) {
+    lcd_.begin(cols, rows);
+    reset();
+  }
+
+  void clear() {
+    for (uint8_t r = 0; r < kLines; ++r) {
+      for (uint8_t c = 0; c < kLineLen; ++c) set(r, c, ' ');
+    }
+    row_ = col_ = 0;
+    shift_ = 0;
+  }
+
+  void setCursor(uint8_t col, uint8_t row) {
+    row_ = row < kLines ? row : kLines - 1;
+    col_ = col % kLineLen;
+  }
+
+  void scrollDisplayLeft() {
+    shift_ = (uint8_t)((shift_ + 1) % kLineLen);
+  }
+
+  size_t write(uint8_t c) override {
+    set(row_, col_, (char)c);
+    // como el HD44780: al final de una línea sigue en la otra
+    if (++col_ >= kLineLen) {
+      col_ = 0;
+      row_ = (uint8_t)((row_ + 1) % kLines);
+    }
+    return 1;
+  }
+  using Print::write;
+
+  // Hay algo que todavía no llegó al LCD
+  bool pending() const {
+    return dirtyCount_ > 0 || lcdShift_ != shift_;
+  }
+
+  // Una vez por pasada
+  void flush() {
+    uint8_t budget = kTransfersPerPass;
+    while (budget > 0 && lcdShift_ != shift_) {
+      // para el lado más corto
+      if ((uint8_t)((shift_ + kLineLen - lcdShift_) % kLineLen) <= kLineLen / 2) {
+        lcd_.scrollDisplayLeft();
+        lcdShift_ = (uint8_t)((lcdShift_ + 1) % kLineLen);
+      } else {
+        lcd_.scrollDisplayRight();
+        lcdShift_ = (uint8_t)((lcdShift_ + kLineLen - 1) % kLineLen);
+      }
+      --budget;
+    }
+    for (uint8_t i = 0; budget > 0 && dirtyCount_ > 0 && i < kLines * kLineLen; ++i) {
+      if (!(dirty_[i >> 3] & (1 << (i & 7)))) continue;
+      uint8_t r = i / kLineLen;
+      uint8_t c = i % kLineLen;
+      if (r != lcdRow_ || c != lcdCol_) {
+        lcd_.setCursor(c, r);
+        if (--budget == 0) {
+          lcdRow_ = r;
+          lcdCol_ = c;
+          return;
+        }
+      }
+      lcd_.write((uint8_t)cells_[r][c]);
+      --budget;
+      dirty_[i >> 3] &= (uint8_t)~(1 << (i & 7));
+      --dirtyCount_;
+      lcdRow_ = r;
+      lcdCol_ = (uint8_t)(c + 1);
+      if (lcdCol_ >= kLineLen) {
+        lcdCol_ = 0;
+        lcdRow_ = (uint8_t)((lcdRow_ + 1) % kLines);
+      }
+    }
+  }
+
+private:
+  LiquidCrystal& lcd_;
+  char cells_[kLines][kLineLen];
+  uint8_t dirty_[kLines * kLineLen / 8];   // un bit por celda
+  uint8_t dirtyCount_;
+  uint8_t row_, col_;                      // cursor de quien escribe
+  uint8_t shift_;
+  uint8_t lcdRow_, lcdCol_;                // cursor del LCD
+  uint8_t lcdShift_;
+
+  // Después de LiquidCrystal::begin(): el LCD está en blanco
+  void reset() {
+    memset(cells_, ' ', sizeof(cells_));
+    memset(dirty_, 0, sizeof(dirty_));
+    dirtyCount_ = 0;
+    row_ = col_ = shift_ = 0;
+    lcdRow_ = lcdCol_ = lcdShift_ = 0;
+  }
+
+  void set(uint8_t r, uint8_t c, char ch) {
+    if (cells_[r][c] == ch) return;
+    cells_[r][c] = ch;
+    uint8_t i = (uint8_t)(r * kLineLen + c);
+    if (!(dirty_[i >> 3] & (1 << (i & 7)))) {
+      dirty_[i >> 3] |= (uint8_t)(1 << (i & 7));
+      ++dirtyCount_;
+    }
+  }
+};
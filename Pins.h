@@ -0,0 +1,38 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Configuración de los pines
+
+// Botones: un lado al pin, el otro a GND (tierra)
+const uint8_t BUTTON_PINS[4] = {2, 3, 4, 5};
+
+// LEDs: pata larga en la resistencia y al pin, pata corta a tierra
+const uint8_t LED_PINS[4] = {8, 9, 10, 11};
+
+// Buzzer pequeño
+const uint8_t BUZZER_PIN = 6;
+
+// Varias estaciones en una Mega (compilar con -DSIMON_STATIONS=2 o 3,
+// ver Stations.h): cada una con sus botones, LEDs, buzzer y LCD
+// (RS, E, D4, D5, D6, D7). Los buzzers comparten el Timer2 de tone().
+#ifndef SIMON_STATIONS
+#define SIMON_STATIONS 1
+#endif
+#if SIMON_STATIONS < 1 || SIMON_STATIONS > 3
+#error "SIMON_STATIONS va de 1 a 3"
+#endif
+
+struct StationPins {
+  uint8_t buttons[4];
+  uint8_t leds[4];
+  uint8_t buzzer;
+  uint8_t lcd[6];
+};
+
+const StationPins STATION_PINS[3] = {
+  {{22, 23, 24, 25}, {26, 27, 28, 29}, 2, {30, 31, 32, 33, 34, 35}},
+  {{36, 37, 38, 39}, {40, 41, 42, 43}, 3, {44, 45, 46, 47, 48, 49}},
+  // A0..A13 de la Mega
+  {{54, 55, 56, 57}, {58, 59, 60, 61}, 5, {62, 63, 64, 65, 66, 67}},
+};
@@ -0,0 +1,121 @@
+#pragma once
+
+// Planificador cooperativo por tiempo: unas pocas tareas periódicas que se
+// corren desde loop() cuando vencen, sin bloquear. La tabla es fija
+// (kMaxTasks) y no usa heap.
+//
+// run() devuelve cuántos ms faltan para la próxima tarea, para poder
+// dormir mientras tanto, y acumula el tiempo que pasó dentro de las tareas
+// para medir el uso de CPU (dutyPermille).
+
+#include <Arduino.h>
+#include "TimeBase.h"
+
+class Scheduler {
+public:
+  typedef void (*TaskFn)(void* ctx);
+
+  static const uint8_t kMaxTasks = 6;
+  static const uint16_t kNever = 0xFFFF;
+
+  Scheduler() : busyUs_(0), statsSinceUs_(0) {
+    for (uint8_t i = 0; i < kMaxTasks; ++i) tasks_[i].fn = nullptr;
+  }
+
+  // Registra una tarea (detenida); devuelve su id o -1 si no hay lugar
+  int8_t add(TaskFn fn, void* ctx, uint16_t periodMs) {
+    for (uint8_t i = 0; i < kMaxTasks; ++i) {
+      if (!tasks_[i].fn) {
+        tasks_[i].fn = fn;
+        tasks_[i].ctx = ctx;
+        tasks_[i].periodMs = periodMs;
+        tasks_[i].active = false;
+        return (int8_t)i;
+      }
+    }
+    return -1;
+  }
+
+  // Primera corrida dentro de delayMs
+  void start(int8_t id, uint16_t delayMs = 0) {
+    start(id, delayMs, Clock::now());
+  }
+
+  void start(int8_t id, uint16_t delayMs, Instant now) {
+    if (id < 0) return;
+    tasks_[id].nextMs = now + msecs(delayMs);
+    tasks_[id].active = true;
+  }
+
+  void stop(int8_t id) {
+    if (id >= 0) tasks_[id].active = false;
+  }
+
+  // Cambia el período y corre la próxima vez a periodMs de la última.
+  // Una tarea puede llamarla sobre sí misma para fijar cuándo vuelve.
+  void setPeriod(int8_t id, uint16_t periodMs) {
+    if (id < 0) return;
+    Task& t = tasks_[id];
+    t.nextMs = t.nextMs - msecs(t.periodMs) + msecs(periodMs);
+    t.periodMs = periodMs;
+  }
+
+  bool active(int8_t id) const {
+    return id >= 0 && tasks_[id].active;
+  }
+
+  uint16_t run() {
+    return run(Clock::now());
+  }
+
+  // Con el instante de esta pasada; se vuelve a leer el reloj solo después
+  // de correr una tarea (puede tardar)
+  uint16_t run(Instant now) {
+    uint16_t next = kNever;
+    for (uint8_t i = 0; i < kMaxTasks; ++i) {
+      Task& t = tasks_[i];
+      if (!t.fn || !t.active) continue;
+      if (now.reached(t.nextMs)) {
+        // sin acumular atraso: si se perdió una vuelta, sigue desde ahora
+        t.nextMs = now + msecs(t.periodMs);
+        unsigned long t0 = micros();
+        t.fn(t.ctx);
+        busyUs_ += micros() - t0;
+        now = Clock::now();
+      }
+      if (!t.active) continue;
+      uint32_t left = now.reached(t.nextMs) ? 0 : t.nextMs.since(now).ms;
+      if (left < next) next = (uint16_t)left;
+    }
+    return next;
+  }
+
+  // Medición de uso de CPU dentro de las tareas
+  void resetStats() {
+    busyUs_ = 0;
+    statsSinceUs_ = micros();
+  }
+
+  uint32_t busyUs() const {
+    return busyUs_;
+  }
+
+  uint16_t dutyPermille() const {
+    // sin aritmética de 64 bits: se divide por el tiempo en ms
+    uint32_t elapsedMs = (micros() - statsSinceUs_) / 1000;
+    return elapsedMs ? (uint16_t)(busyUs_ / elapsedMs) : 0;
+  }
+
+private:
+  struct Task {
+    TaskFn fn;
+    void* ctx;
+    uint16_t periodMs;
+    Instant nextMs;
+    bool active;
+  };
+
+  Task tasks_[kMaxTasks];
+  uint32_t busyUs_;
+  unsigned long statsSinceUs_;
+};
@@ -0,0 +1,1519 @@
+#pragma once
+
+// Clases del juego: periféricos, patrón y máquina de estados.
+// El sketch (main.cpp) crea las instancias; el simulador en la PC crea
+// las suyas para grabar, reproducir y medir partidas.
+
+#include <Arduino.h>
+#include <LiquidCrystal.h>
+#include "GameRecorder.h"
+#include "GameTiming.h"
+#include "TimeBase.h"
+#include "Difficulty.h"
+#include "Calibration.h"
+#include "UsageStats.h"
+#include "HotSeat.h"
+#include "Tracing.h"
+
+// Puntos necesarios para ganar
+const uint8_t WIN_SCORE = 3;
+
+// Estado compacto (compilar con -DSIMON_PACKED) para liberar RAM en el Uno:
+// ButtonReader guarda los tiempos en 16 bits y las ventanas en 8,
+// PatternManager guarda cuatro pasos por byte y las banderas del
+// GameController van en bits. Las dos versiones se comportan igual
+// (simon_diff --cand compacto lo comprueba); la compacta cuesta un poco
+// más de CPU por los corrimientos.
+
+#ifdef SIMON_PACKED
+#define SIMON_BIT : 1
+#else
+#define SIMON_BIT
+#endif
+
+// Clases para los componentes de hardware :)
+
+// lit_ tiene el nivel que quedó escrito en cada pin (bit i = LED i), así
+// apply() escribe solo los que cambian.
+class LEDDriver {
+public:
+  LEDDriver(const uint8_t* pins, uint8_t count) : pins_(pins), count_(count), lit_(0) {}
+
+  void begin() {
+    for (uint8_t i = 0; i < count_; ++i) {
+      pinMode(pins_[i], OUTPUT);
+      digitalWrite(pins_[i], LOW);
+    }
+    lit_ = 0;
+  }
+
+  void on(uint8_t idx) {
+    if (idx < count_) apply((uint8_t)(1u << idx), 0xFF);
+  }
+
+  void off(uint8_t idx) {
+    if (idx < count_) apply((uint8_t)(1u << idx), 0);
+  }
+
+  void offAll() {
+    apply(0xFF, 0);
+  }
+
+  // Los LEDs de `mask` quedan como dicen los bits de `levels`; se escriben
+  // solo los que cambian. En el AVR los que comparten puerto van en una
+  // sola escritura. Devuelve cuántos pines cambiaron.
+  uint8_t apply(uint8_t mask, uint8_t levels) {
+    uint8_t diff = (uint8_t)((levels ^ lit_) & mask & allMask());
+    if (!diff) return 0;
+    TRACE_INSTANT("LEDDriver::apply");
+    lit_ ^= diff;
+#ifdef __AVR__
+    // como mucho un puerto por LED
+    volatile uint8_t* port[8];
+    uint8_t set[8], clear[8];
+    uint8_t ports = 0;
+    for (uint8_t i = 0; i < count_; ++i) {
+      if (!(diff & (1u << i))) continue;
+      volatile uint8_t* reg = portOutputRegister(digitalPinToPort(pins_[i]));
+      uint8_t bit = digitalPinToBitMask(pins_[i]);
+      uint8_t p = 0;
+      while (p < ports && port[p] != reg) ++p;
+      if (p == ports) {
+        port[p] = reg;
+        set[p] = clear[p] = 0;
+        ++ports;
+      }
+      if (lit_ & (1u << i)) set[p] |= bit;
+      else clear[p] |= bit;
+    }
+    for (uint8_t p = 0; p < ports; ++p) {
+      uint8_t sreg = SREG;
+      cli();
+      *port[p] = (uint8_t)((*port[p] & ~clear[p]) | set[p]);
+      SREG = sreg;
+    }
+#else
+    for (uint8_t i = 0; i < count_; ++i) {
+      if (diff & (1u << i)) digitalWrite(pins_[i], (lit_ & (1u << i)) ? HIGH : LOW);
+    }
+#endif
+    return (uint8_t)__builtin_popcount(diff);
+  }
+
+  // Bit i prendido si el LED i está encendido
+  uint8_t lit() const { return lit_; }
+  uint8_t count() const { return count_; }
+
+private:
+  const uint8_t* pins_;
+  uint8_t count_;
+  uint8_t lit_;
+
+  uint8_t allMask() const { return (uint8_t)((1u << count_) - 1); }
+};
+
+// Con Packed los tiempos son ShortInstant (TimeBase.h): dan la vuelta a
+// los 65 s, así que update() no deja que la edad de un cambio pase de
+// kMaxAge. Todas las ventanas son mucho más cortas, así que se
+// compara igual que con 32 bits.
+//
+// Además de los flancos, ButtonReader reconoce gestos a partir de los
+// mismos tiempos del antirrebote (lastChange_ es el momento de la última
+// transición de cada botón), sin leer los pines de más:
+//   pulsación larga   sigue apretado kLongMs (avisa una vez)
+//   doble pulsación   se vuelve a apretar a menos de kDoubleMs de soltarlo
+//   acorde            dos o más apretados con menos de kChordMs entre el
+//                     primero y el último (avisa una vez, hasta soltar todos)
+// Cada gesto se ve durante una sola pasada, como risingEdge().
+
+template <bool Packed>
+class BasicButtonReader {
+public:
+  typedef typename PickType<Packed, ShortInstant, Instant>::type Time;
+  typedef typename PickType<Packed, uint8_t, uint16_t>::type Window;
+
+  static const uint16_t kLongMs = 1000;
+  static const uint16_t kDoubleMs = 300;
+  static const uint16_t kChordMs = 80;
+  static const uint16_t kMaxAge = 0x7FFF;    // solo con Packed
+
+  BasicButtonReader(const uint8_t* pins, uint8_t count, uint16_t debounceMs = 25)
+    : pins_(pins), count_(count), held_(0),
+      longDone_(0), longPress_(0), doublePress_(0), chord_(0), chordDone_(false) {
+    for (uint8_t i = 0; i < 4; ++i) {
+      debounceMs_[i] = window(debounceMs);
+      curr_[i] = prev_[i] = HIGH;
+      edge_[i] = false;
+    }
+  }
+
+  void begin() {
+    held_ = longDone_ = longPress_ = doublePress_ = chord_ = 0;
+    chordDone_ = false;
+    for (uint8_t i = 0; i < count_; ++i) {
+      pinMode(pins_[i], INPUT_PULLUP);
+      curr_[i] = prev_[i] = digitalRead(pins_[i]);
+      // como si se hubiera soltado hace kDoubleMs: el primer toque no es doble
+      lastChange_[i] = Time::from(Clock::now()) - Duration{kDoubleMs};
+      edge_[i] = false;
+      if (curr_[i] == LOW) held_ |= (uint8_t)(1 << i);
+    }
+    // lo que ya estaba apretado al arrancar no cuenta como gesto
+    longDone_ = held_;
+    chordDone_ = held_ != 0;
+  }
+
+  // Niveles crudos de los pines: bit i = botón i en HIGH
+  uint8_t readPins() const {
+    uint8_t levels = 0;
+    for (uint8_t i = 0; i < count_; ++i) {
+      if (digitalRead(pins_[i]) == HIGH) levels |= (uint8_t)(1 << i);
+    }
+    return levels;
+  }
+
+  void update() {
+    update(readPins(), Clock::now());
+  }
+
+  void update(uint8_t levels) {
+    update(levels, Clock::now());
+  }
+
+  // Antirrebote sobre niveles ya leídos (de los pines o de una grabación)
+  // con el instante de esta pasada
+  void update(uint8_t levels, Instant at) {
+    Time now = Time::from(at);
+    bool pressed = false;
+    longPress_ = doublePress_ = chord_ = 0;
+    for (uint8_t i = 0; i < count_; ++i) {
+      uint8_t r = (levels >> i) & 1 ? HIGH : LOW;
+      uint8_t bit = (uint8_t)(1 << i);
+      edge_[i] = false;
+      if (Packed && age(now, i) > kMaxAge) lastChange_[i] = now - Duration{kMaxAge};
+      if (r != curr_[i] && age(now, i) >= debounceMs_[i]) {
+        prev_[i] = curr_[i];
+        curr_[i] = r;
+        if (prev_[i] == HIGH && curr_[i] == LOW) {
+          edge_[i] = true;
+          pressed = true;
+          held_ |= bit;
+          // lastChange_ todavía es el momento en que se soltó
+          if (age(now, i) < kDoubleMs) doublePress_ |= bit;
+          TRACE_INSTANT("boton presionado");
+        } else {
+          held_ &= (uint8_t)~bit;
+          longDone_ &= (uint8_t)~bit;
+          TRACE_INSTANT("boton soltado");
+        }
+        lastChange_[i] = now;
+      } else if ((held_ & ~longDone_ & bit) && age(now, i) >= kLongMs) {
+        longPress_ |= bit;
+        longDone_ |= bit;
+        TRACE_INSTANT("pulsacion larga");
+      }
+    }
+    if (!held_) chordDone_ = false;
+    if (pressed && !chordDone_ && (held_ & (held_ - 1))) detectChord(now);
+  }
+
+  bool isPressed(uint8_t idx) const {
+    return (idx < count_) ? (curr_[idx] == LOW) : false;
+  }
+
+  bool risingEdge(uint8_t idx) const {
+    return (idx < count_) ? edge_[idx] : false;
+  }
+
+  // La misma ventana para todos los botones
+  void setDebounce(uint16_t ms) {
+    for (uint8_t i = 0; i < 4; ++i) debounceMs_[i] = window(ms);
+  }
+
+  // Ventana de un botón (la calibración le da una a cada uno)
+  void setDebounce(uint8_t idx, uint16_t ms) {
+    if (idx < 4) debounceMs_[idx] = window(ms);
+  }
+
+  uint16_t debounce(uint8_t idx) const {
+    return idx < 4 ? debounceMs_[idx] : 0;
+  }
+
+  // La ventana más larga
+  uint16_t debounce() const {
+    uint16_t m = 0;
+    for (uint8_t i = 0; i < count_; ++i) {
+      if (debounceMs_[i] > m) m = debounceMs_[i];
+    }
+    return m;
+  }
+
+  uint8_t anyRisingEdge() const {
+    for (uint8_t i = 0; i < count_; ++i) {
+      if (edge_[i]) return i;
+    }
+    return 0xFF;
+  }
+
+  bool longPress(uint8_t idx) const {
+    return (longPress_ >> idx) & 1;
+  }
+
+  bool doublePress(uint8_t idx) const {
+    return (doublePress_ >> idx) & 1;
+  }
+
+  // Botones del acorde que se formó en esta pasada (bit i = botón i), o 0
+  uint8_t chord() const {
+    return chord_;
+  }
+
+private:
+  const uint8_t* pins_;
+  uint8_t count_;
+  Window debounceMs_[4];
+  uint8_t curr_[4];
+  uint8_t prev_[4];
+  Time lastChange_[4];
+  bool edge_[4];
+  uint8_t held_;            // bit i = botón i apretado
+  uint8_t longDone_;        // ya avisó la pulsación larga
+  uint8_t longPress_;       // gestos de esta pasada
+  uint8_t doublePress_;
+  uint8_t chord_;
+  bool chordDone_;
+
+  typedef typename Time::Duration Duration;
+
+  // ms desde el último cambio del botón i
+  typename PickType<Packed, uint16_t, uint32_t>::type age(Time now, uint8_t i) const {
+    return now.since(lastChange_[i]).ms;
+  }
+
+  static Window window(uint16_t ms) {
+    return (Window)(Packed && ms > 0xFF ? 0xFF : ms);
+  }
+
+  // Recién apretado con otro(s): acorde si todos entraron en kChordMs
+  void detectChord(Time now) {
+    for (uint8_t i = 0; i < count_; ++i) {
+      if ((held_ >> i) & 1 && age(now, i) >= kChordMs) return;
+    }
+    chord_ = held_;
+    chordDone_ = true;
+    TRACE_INSTANT("acorde");
+  }
+};
+
+#ifdef SIMON_PACKED
+typedef BasicButtonReader<true> ButtonReader;
+#else
+typedef BasicButtonReader<false> ButtonReader;
+#endif
+
+class Buzzer {
+public:
+  explicit Buzzer(uint8_t pin) : pin_(pin), sound_(true) {}
+
+  void begin() {
+    pinMode(pin_, OUTPUT);
+    digitalWrite(pin_, LOW);
+  }
+
+  void beep(uint16_t ms, unsigned int freq) {
+    if (!sound_) return;
+    TRACE_INSTANT("Buzzer::beep");
+    tone(pin_, freq, ms);
+  }
+
+  void click(uint8_t idx) {
+    if (idx < 4) beep(120, clickFreq(idx));
+  }
+
+  // Tono de cada color
+  static unsigned int clickFreq(uint8_t idx) {
+    static const unsigned int tones[4] = {800, 950, 1100, 1250};
+    return tones[idx];
+  }
+
+  void success() {
+    TRACE_SCOPE("Buzzer::success");
+    beep(150, 1500);
+    delay(50);
+    beep(150, 1800);
+    delay(50);
+    beep(200, 2000);
+  }
+
+  void fail() {
+    TRACE_SCOPE("Buzzer::fail");
+    beep(300, 300);
+    delay(100);
+    beep(250, 200);
+  }
+
+  void stop() {
+    noTone(pin_);
+  }
+
+  // Con tone() el piezo suena siempre igual de fuerte: el "volumen" del
+  // menú de ajustes es con o sin sonido
+  void setSound(bool on) {
+    sound_ = on;
+    if (!on) stop();
+  }
+
+  bool sound() const {
+    return sound_;
+  }
+
+private:
+  uint8_t pin_;
+  bool sound_;
+};
+
+// Lcd: LiquidCrystal, o cualquiera con sus begin(), clear(), setCursor(),
+// scrollDisplayLeft() y Print (LcdBuffer.h en las estaciones)
+template <typename Lcd>
+class BasicDisplayLCD {
+public:
+  explicit BasicDisplayLCD(Lcd& lcd) : lcd_(lcd) {}
+
+  void begin() {
+    lcd_.begin(16, 2);
+    lcd_.clear();
+  }
+
+  void showWelcome(int highScore) {
+    TRACE_SCOPE("DisplayLCD::showWelcome");
+    lcd_.clear();
+    lcd_.setCursor(0, 0);
+    lcd_.print("SIMON DICE");
+    lcd_.setCursor(0, 1);
+    lcd_.print("High: ");
+    lcd_.print(highScore);
+  }
+
+  void showLevel(uint8_t level, int highScore) {
+    TRACE_SCOPE("DisplayLCD::showLevel");
+    lcd_.clear();
+    lcd_.setCursor(0, 0);
+    lcd_.print("Nivel: ");
+    lcd_.print(level);
+    lcd_.setCursor(0, 1);
+    lcd_.print("High: ");
+    lcd_.print(highScore);
+  }
+
+  void showGameOver(int score, int highScore) {
+    TRACE_SCOPE("DisplayLCD::showGameOver");
+    lcd_.clear();
+    lcd_.setCursor(0, 0);
+    lcd_.print("Game Over");
+    lcd_.setCursor(0, 1);
+    lcd_.print("You: ");
+    lcd_.print(score);
+    lcd_.print(" H:");
+    lcd_.print(highScore);
+  }
+
+  void showPressToStart() {
+    TRACE_SCOPE("DisplayLCD::showPressToStart");
+    lcd_.clear();
+    lcd_.setCursor(0, 0);
+    lcd_.print("Presiona un boton");
+    lcd_.setCursor(0, 1);
+    lcd_.print("para iniciar");
+  }
+
+  void showWin(int score, int highScore) {
+    TRACE_SCOPE("DisplayLCD::showWin");
+    lcd_.clear();
+    lcd_.setCursor(0, 0);
+    lcd_.print("!GANASTE!");
+    lcd_.setCursor(0, 1);
+    lcd_.print("Score: ");
+    lcd_.print(score);
+    lcd_.print(" H:");
+    lcd_.print(highScore);
+  }
+
+  // Menú de ajustes: la opción arriba y su valor abajo (text si no es
+  // nullptr, si no el número)
+  void showSetting(const char* name, int value, const char* text = nullptr) {
+    TRACE_SCOPE("DisplayLCD::showSetting");
+    lcd_.clear();
+    lcd_.setCursor(0, 0);
+    lcd_.print(name);
+    lcd_.setCursor(0, 1);
+    if (text) lcd_.print(text);
+    else lcd_.print(value);
+  }
+
+  // Un número por botón en la fila de abajo (4 columnas cada uno)
+  void showButtonValues(const char* title, const uint8_t* values, uint8_t count) {
+    TRACE_SCOPE("DisplayLCD::showButtonValues");
+    lcd_.clear();
+    lcd_.setCursor(0, 0);
+    lcd_.print(title);
+    for (uint8_t i = 0; i < count; ++i) showButtonValue(i, values[i]);
+  }
+
+  // Solo el de un botón: tres transferencias
+  void showButtonValue(uint8_t idx, uint8_t value) {
+    lcd_.setCursor((uint8_t)(4 * idx), 1);
+    lcd_.print(value);
+    if (value < 10) lcd_.print(' ');
+  }
+
+  // Página de estadísticas de uso: 0 partidas y ganadas, 1 nivel medio y
+  // el color que más se falla
+  void showUsage(uint8_t page, const UsageStats& u) {
+    TRACE_SCOPE("DisplayLCD::showUsage");
+    lcd_.clear();
+    lcd_.setCursor(0, 0);
+    if (page == 0) {
+      lcd_.print("Partidas ");
+      lcd_.print(u.games());
+      lcd_.setCursor(0, 1);
+      lcd_.print("Ganadas ");
+      lcd_.print((unsigned int)u.winPercent());
+      lcd_.print('%');
+      return;
+    }
+    // 8.8 a un decimal, redondeado
+    uint16_t tenths = (uint16_t)(((uint32_t)u.levelMeanQ8() * 10 + 128) >> 8);
+    lcd_.print("Nivel medio ");
+    lcd_.print(tenths / 10);
+    lcd_.print('.');
+    lcd_.print(tenths % 10);
+    lcd_.setCursor(0, 1);
+    uint8_t m = u.mostMissed();
+    if (m == UsageStats::kNoMiss) {
+      lcd_.print("Sin fallos");
+    } else {
+      lcd_.print("Mas falla: ");
+      lcd_.print((unsigned int)(m + 1));
+    }
+  }
+
+  // Marquesina: cada fila (texto en flash, hasta 40 caracteres) se escribe
+  // una sola vez entera en la DDRAM, rellena con espacios, y después la
+  // corre el comando de desplazamiento del HD44780. Cada paso es una sola
+  // transferencia en vez de reescribir 16 caracteres. El desplazamiento
+  // mueve las dos filas juntas; cualquier otra pantalla lo vuelve a cero
+  // con clear().
+  void showMarquee(const char* top, const char* bottom) {
+    TRACE_SCOPE("DisplayLCD::showMarquee");
+    lcd_.clear();
+    writeDdramLine(0, top);
+    writeDdramLine(1, bottom);
+  }
+
+  void marqueeStep() {
+    lcd_.scrollDisplayLeft();
+  }
+
+  // Hot seat: borra y escribe los puntos de todos abajo ("1:3 2x1 3:0")
+  void showPlayers(const PlayerArena& a) {
+    TRACE_SCOPE("DisplayLCD::showPlayers");
+    lcd_.clear();
+    for (uint8_t i = 0; i < a.count; ++i) showPlayerScore(i, a.slot[i]);
+  }
+
+  // Las cuatro columnas de un jugador; una x si ya perdió
+  void showPlayerScore(uint8_t idx, const PlayerSlot& p) {
+    lcd_.setCursor(4 * idx, 1);
+    lcd_.print(idx + 1);
+    lcd_.print(p.out ? 'x' : ':');
+    lcd_.print(p.score);
+    if (p.score < 10) lcd_.print(' ');
+  }
+
+  // Fila de arriba sin borrar: nivel y de quién es el turno
+  void showTurn(uint8_t idx, uint8_t level) {
+    TRACE_SCOPE("DisplayLCD::showTurn");
+    lcd_.setCursor(0, 0);
+    lcd_.print("Nivel: ");
+    lcd_.print(level);
+    lcd_.print(level < 10 ? "  J" : " J");
+    lcd_.print(idx + 1);
+  }
+
+  // "J2" junto a Game Over / !GANASTE!
+  void showPlayerTag(uint8_t idx) {
+    lcd_.setCursor(10, 0);
+    lcd_.print('J');
+    lcd_.print(idx + 1);
+  }
+
+  // Nivel del rival en el modo versus, arriba a la derecha ("R:12x" si
+  // ya terminó). Solo escribe esas columnas: no borra la pantalla.
+  void showRival(uint8_t level, bool out) {
+    TRACE_SCOPE("DisplayLCD::showRival");
+    lcd_.setCursor(11, 0);
+    lcd_.print("R:");
+    lcd_.print(level);
+    lcd_.print(out ? 'x' : ' ');
+    if (level < 10) lcd_.print(' ');
+  }
+
+private:
+  static const uint8_t kDdramCols = 40;
+
+  void writeDdramLine(uint8_t row, const char* text) {
+    lcd_.setCursor(0, row);
+    bool end = false;
+    for (uint8_t i = 0; i < kDdramCols; ++i) {
+      char c = end ? 0 : (char)pgm_read_byte(text + i);
+      if (!c) {
+        end = true;
+        c = ' ';
+      }
+      lcd_.write((uint8_t)c);
+    }
+  }
+
+  Lcd& lcd_;
+};
+
+typedef BasicDisplayLCD<LiquidCrystal> DisplayLCD;
+
+// Patrón del juego. Con Packed cada paso ocupa dos bits (hay cuatro
+// colores): 13 bytes en vez de 50.
+
+template <bool Packed>
+class BasicPatternManager {
+public:
+  static const uint8_t kMaxSteps = 50;
+
+  BasicPatternManager(uint8_t colors, uint8_t maxLen = kMaxSteps)
+    : colors_(colors), maxLen_(maxLen > kMaxSteps ? kMaxSteps : maxLen), length_(0),
+      seed_(0) {}
+
+  void begin() {
+    length_ = 0;
+    randomSeed(analogRead(0));
+  }
+
+  // Semilla nueva para cada partida; se guarda para poder repetirla
+  uint32_t newSeed() const {
+    uint32_t s = (uint32_t)random(1, 0x7FFFFFFFL) ^ micros();
+    return s ? s : 1;
+  }
+
+  void reset(uint32_t seed) {
+    length_ = 0;
+    seed_ = seed;
+    randomSeed(seed);
+  }
+
+  uint32_t seed() const {
+    return seed_;
+  }
+
+  // Los pasos que agrega cada ronda dependen de la variante del juego
+  template <typename Mode>
+  void addRound() {
+    for (uint8_t i = 0; i < Mode::kStepsPerRound; ++i) addStep();
+  }
+
+  void addStep() {
+    TRACE_INSTANT("PatternManager::addStep");
+    if (length_ < maxLen_) {
+      uint8_t step = (uint8_t)random(0, colors_);
+      if (Packed) {
+        uint8_t shift = (uint8_t)((length_ & 3) * 2);
+        uint8_t& b = pattern_[length_ >> 2];
+        b = (uint8_t)((b & ~(3 << shift)) | (step << shift));
+      } else {
+        pattern_[length_] = step;
+      }
+      ++length_;
+    }
+  }
+
+  uint8_t getStep(uint8_t idx) const {
+    if (Packed) return (uint8_t)((pattern_[idx >> 2] >> ((idx & 3) * 2)) & 3);
+    return pattern_[idx];
+  }
+
+  uint8_t length() const {
+    return length_;
+  }
+
+  // Cuántos colores usa el patrón (los primeros n botones); rige desde la
+  // próxima partida
+  void setColors(uint8_t n) {
+    colors_ = n;
+  }
+
+  uint8_t colors() const {
+    return colors_;
+  }
+
+private:
+  uint8_t colors_;
+  uint8_t maxLen_;
+  uint8_t length_;
+  uint32_t seed_;
+  uint8_t pattern_[Packed ? (kMaxSteps + 3) / 4 : kMaxSteps];
+};
+
+#ifdef SIMON_PACKED
+typedef BasicPatternManager<true> PatternManager;
+#else
+typedef BasicPatternManager<false> PatternManager;
+#endif
+
+// FSM DEL JUEGO
+
+// Variantes del juego. Cada una es una política que se elige al compilar
+// (SIMON_MODE): el GameController la usa a través de funciones estáticas
+// que se resuelven en línea, así que la variante elegida no agrega
+// llamadas ni comparaciones, y las que no se usan no ocupan flash.
+//
+//   kStepsPerRound          pasos nuevos por ronda
+//   expected(i, len)        qué paso del patrón va en la respuesta i
+//   onMs/offMs(t, level)    tiempos del patrón en ese nivel
+
+struct ClassicMode {
+  static const uint8_t kStepsPerRound = 1;
+
+  static uint8_t expected(uint8_t input, uint8_t) {
+    return input;
+  }
+
+  static uint16_t onMs(const GameTiming& t, uint8_t) {
+    return t.onMs;
+  }
+
+  static uint16_t offMs(const GameTiming& t, uint8_t) {
+    return t.offMs;
+  }
+};
+
+// Hay que repetir el patrón al revés
+struct ReverseMode : ClassicMode {
+  static uint8_t expected(uint8_t input, uint8_t len) {
+    return (uint8_t)(len - 1 - input);
+  }
+};
+
+// Cada nivel muestra el patrón un 1/8 más rápido, hasta la cuarta parte
+struct SpeedMode : ClassicMode {
+  static uint16_t scale(uint16_t ms, uint8_t level) {
+    uint8_t cuts = level > 7 ? 6 : (uint8_t)(level - 1);
+    return (uint16_t)(ms - (ms >> 3) * cuts);
+  }
+
+  static uint16_t onMs(const GameTiming& t, uint8_t level) {
+    return scale(t.onMs, level);
+  }
+
+  static uint16_t offMs(const GameTiming& t, uint8_t level) {
+    return scale(t.offMs, level);
+  }
+};
+
+// Dos pasos nuevos por ronda
+struct AddTwoMode : ClassicMode {
+  static const uint8_t kStepsPerRound = 2;
+};
+
+#ifndef SIMON_MODE
+#define SIMON_MODE ClassicMode
+#endif
+
+enum class State : uint8_t {
+  IDLE,
+  SHOW_PATTERN,
+  WAIT_INPUT,
+  GAME_OVER,
+  SETTINGS,
+  CALIBRATE,
+  STATS
+};
+
+inline const char* stateName(State s) {
+  switch (s) {
+    case State::IDLE:         return "IDLE";
+    case State::SHOW_PATTERN: return "SHOW_PATTERN";
+    case State::WAIT_INPUT:   return "WAIT_INPUT";
+    case State::GAME_OVER:    return "GAME_OVER";
+    case State::SETTINGS:     return "SETTINGS";
+    case State::CALIBRATE:    return "CALIBRATE";
+    case State::STATS:        return "STATS";
+  }
+  return "?";
+}
+
+// Periféricos que maneja el GameController, elegidos al compilar como la
+// variante. Cada uno es un tipo concreto (sin funciones virtuales): el
+// sketch usa los de esta placa y las herramientas de la PC pueden poner
+// otros con los mismos métodos (que cuenten, graben o no hagan nada) sin
+// tocar el juego. Uno nuevo puede heredar del de la placa y tapar solo
+// lo que cambia.
+//
+// kNonBlocking: el GameController no llama a delay() (el LED del botón
+// apretado queda prendido kPressMs mientras siguen las pasadas). Hace
+// falta cuando varias estaciones comparten el MCU (Stations.h); Sound
+// tiene que tocar las melodías sin bloquear también.
+struct ArduinoPeripherals {
+  typedef PatternManager Pattern;
+  typedef LEDDriver      Leds;
+  typedef ButtonReader   Buttons;
+  typedef Buzzer         Sound;
+  typedef DisplayLCD     Display;
+  static const bool kNonBlocking = false;
+};
+
+template <typename Mode, typename Periph = ArduinoPeripherals>
+class BasicGameController {
+public:
+  typedef typename Periph::Pattern Pattern;
+  typedef typename Periph::Leds    Leds;
+  typedef typename Periph::Buttons Buttons;
+  typedef typename Periph::Sound   Sound;
+  typedef typename Periph::Display Display;
+
+  // Acorde de los botones 1 y 4 en IDLE: menú de ajustes
+  static const uint8_t kSettingsChord = 0x09;
+  // Acorde de los botones 2 y 3 en IDLE: estadísticas de uso
+  static const uint8_t kStatsChord = 0x06;
+  static const unsigned long kStatsIdleMs = 10000;
+  static const uint8_t kStatsPages = 2;
+  static const unsigned long kSettingsIdleMs = 30000;
+  static const unsigned long kCalibrateMs = 60000;
+  static const uint8_t kSpeedMin = 1;
+  static const uint8_t kSpeedMax = 5;
+  static const uint8_t kColorsMin = 2;
+  // LED y click de cada botón apretado en WAIT_INPUT
+  static const uint16_t kPressMs = 120;
+  // Sin bloquear el LCD se escribe en varias pasadas (LcdBuffer.h): el
+  // primer paso del patrón espera esto para que el nivel ya se vea
+  static const uint16_t kLevelLeadMs = 50;
+  // una reproducción sin eventos ni cambios de estado por el tiempo límite
+  // de respuesta más esto se da por terminada (ver checkReplay)
+  static const unsigned long kReplayTailMs = 5000;
+
+  BasicGameController(Pattern& pm,
+                 Leds& leds,
+                 Buttons& buttons,
+                 Sound& buzzer,
+                 Display& display)
+    : pm_(pm), leds_(leds), buttons_(buttons),
+      buzzer_(buzzer), display_(display),
+      state_(State::IDLE),
+      level_(0), indexPattern_(0), indexInput_(0),
+      score_(0), highScore_(0),
+      timing_(DEFAULT_TIMING),
+      winScore_(WIN_SCORE), difficulty_(nullptr),
+      recorder_(nullptr), replay_(nullptr), players_(nullptr),
+      armedBtn_(0), settingsItem_(0),
+      calibrator_(nullptr), usage_(nullptr), missed_(UsageStats::kNoMiss),
+      statsPage_(0), frame_{0, 0, kNoClick}, ledOn_(false), won_(false), gate_(false), roundOpen_(true),
+      armed_(false), settingsChanged_(false), pressing_(false) {}
+
+  void begin() {
+    pm_.begin();
+    state_ = State::IDLE;
+    replay_ = nullptr;
+    level_ = 0;
+    score_ = 0;
+    won_ = false;
+    display_.begin();
+    display_.showPressToStart();
+  }
+
+  void loop() {
+    loop(Clock::now());
+  }
+
+  // Una pasada con el instante que ya leyó el loop() del sketch. Los
+  // handlers anotan los LEDs y el click en frame_; al final se aplica
+  // lo que cambió.
+  void loop(Instant now) {
+    if (replay_) checkReplay(now);
+    uint8_t levels = replay_ ? replay_->levels(now.ms()) : buttons_.readPins();
+    if (recorder_) recorder_->sample(levels, now.ms());
+    buttons_.update(levels, now);
+
+    switch (state_) {
+      case State::IDLE:         handleIdle(now);         break;
+      case State::SHOW_PATTERN: handleShowPattern(now);  break;
+      case State::WAIT_INPUT:   handleWaitInput(now);    break;
+      case State::GAME_OVER:    handleGameOver(now);     break;
+      case State::SETTINGS:     handleSettings(now);     break;
+      case State::CALIBRATE:    handleCalibrate(levels, now); break;
+      case State::STATS:        handleStats(now);        break;
+    }
+    commitOutputs();
+  }
+
+  // Graba cada partida en rec (nullptr para dejar de grabar)
+  void setRecorder(InputRecorder* rec) {
+    recorder_ = rec;
+  }
+
+  // La próxima partida sale de la grabación en vez de los botones.
+  // Solo desde IDLE; al llegar a GAME_OVER vuelven los botones reales, o
+  // antes si la grabación se acaba sin llegar (checkReplay).
+  bool startReplay(InputReplay* replay) {
+    if (state_ != State::IDLE || !replay->loaded()) return false;
+    replay_ = replay;
+    replayAt_ = Clock::now();
+    return true;
+  }
+
+  // Empieza una partida con esta semilla, como un botón en IDLE. También
+  // sirve desde GAME_OVER (el modo versus arranca la del otro tablero).
+  // players > 1 solo si hay hot seat (setPlayers).
+  void startGame(uint32_t seed, uint8_t players = 1) {
+    newGame(seed, players, Clock::now());
+    commitOutputs();
+  }
+
+  // Dificultad adaptativa (nullptr = tiempos fijos y WIN_SCORE). Pisa los
+  // tiempos de setTiming() entre rondas.
+  void setDifficulty(AdaptiveDifficulty* d) {
+    difficulty_ = d;
+    if (!d) winScore_ = WIN_SCORE;
+  }
+
+  uint8_t winScore() const {
+    return winScore_;
+  }
+
+  // Puntos para ganar fijos; con dificultad adaptativa se recalculan en
+  // cada partida
+  void setWinScore(uint8_t w) {
+    winScore_ = w;
+  }
+
+  // Arena para el hot seat (nullptr = solo juego clásico). En IDLE el
+  // botón 1 arranca una partida de un jugador, el 2 de dos, etc.
+  void setPlayers(PlayerArena* arena) {
+    players_ = arena;
+    if (arena) arena->count = 1;
+  }
+
+  bool hotSeat() const {
+    return players_ && players_->active();
+  }
+
+  // Jugador de turno (0 si no hay hot seat)
+  uint8_t turn() const {
+    return hotSeat() ? players_->turn : 0;
+  }
+
+  // Con la compuerta puesta cada ronda espera a openRound() (modo versus)
+  void setRoundGate(bool on) {
+    gate_ = on;
+    if (!on) roundOpen_ = true;
+  }
+
+  bool waitingRound() const {
+    return state_ == State::SHOW_PATTERN && !roundOpen_;
+  }
+
+  // El patrón de la ronda en espera arranca en `at` (puede ser pasado)
+  void openRound(unsigned long at) {
+    if (!waitingRound()) return;
+    roundOpen_ = true;
+    lastChange_ = Instant::fromMs(at);
+  }
+
+  void setTiming(const GameTiming& t) {
+    timing_ = t;
+  }
+
+  const GameTiming& timing() const {
+    return timing_;
+  }
+
+  // Velocidad del menú de ajustes (1..5, 3 = DEFAULT_TIMING)
+  uint8_t speed() const {
+    int s = (700 - (int)timing_.onMs) / 100;
+    return (uint8_t)(s < kSpeedMin ? kSpeedMin : s > kSpeedMax ? kSpeedMax : s);
+  }
+
+  void setSpeed(uint8_t s) {
+    timing_.onMs = (uint16_t)(700 - 100 * s);
+    timing_.offMs = timing_.onMs / 2;
+  }
+
+  uint8_t colors() const { return pm_.colors(); }
+  void setColors(uint8_t n) { pm_.setColors(n); }
+  bool sound() const { return buzzer_.sound(); }
+  void setSound(bool on) { buzzer_.setSound(on); }
+
+  // Calibración del antirrebote desde el menú (nullptr = sin la opción)
+  void setCalibrator(BounceCalibrator* c) {
+    calibrator_ = c;
+  }
+
+  // Estadísticas de uso (nullptr = no se cuentan ni hay página): se
+  // actualizan al llegar a GAME_OVER, salvo las partidas reproducidas
+  void setUsage(UsageStats* u) {
+    usage_ = u;
+  }
+
+  // Un botón ya se apretó en IDLE y la partida arranca en kChordMs
+  bool starting() const { return armed_; }
+
+  // true una vez al salir del menú si algo cambió (para grabarlo)
+  bool takeSettingsChanged() {
+    if (state_ == State::SETTINGS || !settingsChanged_) return false;
+    settingsChanged_ = false;
+    return true;
+  }
+
+  bool replaying() const { return replay_ != nullptr; }
+  State state() const { return state_; }
+  uint8_t level() const { return level_; }
+  int score() const { return score_; }
+  int highScore() const { return highScore_; }
+  bool won() const { return won_; }
+  uint32_t seed() const { return pm_.seed(); }
+
+#ifdef SIMON_HOST
+  // Escrituras a los pines de los LEDs que pidieron los handlers (como si
+  // cada on/off fuera directo al pin) y las que hubo de verdad
+  struct OutputStats {
+    uint64_t requested = 0;
+    uint64_t written = 0;
+  };
+
+  const OutputStats& outputStats() const { return outputStats_; }
+#endif
+
+private:
+  // Lo que los handlers quieren en las salidas durante esta pasada
+  struct OutputFrame {
+    uint8_t touched;        // LEDs que se fijaron (los demás no se tocan)
+    uint8_t leds;           // nivel pedido para cada uno
+    uint8_t click;          // color a sonar (kNoClick = ninguno)
+  };
+  static const uint8_t kNoClick = 0xFF;
+
+  Pattern& pm_;
+  Leds& leds_;
+  Buttons& buttons_;
+  Sound& buzzer_;
+  Display& display_;
+
+  State state_;
+  uint8_t level_;
+  uint8_t indexPattern_;
+  uint8_t indexInput_;
+  Instant lastChange_;
+  int score_;
+  int highScore_;
+  GameTiming timing_;
+  uint8_t winScore_;
+  AdaptiveDifficulty* difficulty_;
+  InputRecorder* recorder_;
+  InputReplay* replay_;
+  Instant replayAt_;        // cuándo se cargó replay_
+  PlayerArena* players_;
+  // en IDLE, el botón que va a arrancar la partida; en WAIT_INPUT sin
+  // bloquear, el que se está mostrando y hasta cuándo
+  uint8_t armedBtn_;
+  Instant armedAt_;
+  uint8_t settingsItem_;
+  BounceCalibrator* calibrator_;
+  UsageStats* usage_;
+  uint8_t missed_;          // color que se esperaba al fallar
+  uint8_t statsPage_;
+  OutputFrame frame_;
+#ifdef SIMON_HOST
+  OutputStats outputStats_;
+#endif
+  // banderas juntas: con SIMON_PACKED entran en un byte
+  bool ledOn_ SIMON_BIT;
+  bool won_ SIMON_BIT;
+  bool gate_ SIMON_BIT;
+  bool roundOpen_ SIMON_BIT;
+  bool armed_ SIMON_BIT;
+  bool settingsChanged_ SIMON_BIT;
+  bool pressing_ SIMON_BIT;
+
+  enum SettingsItem : uint8_t {
+    kItemSpeed, kItemSound, kItemColors, kItemReset, kItemCalibrate, kItems
+  };
+
+  void ledOn(uint8_t i) {
+    frame_.touched |= (uint8_t)(1u << i);
+    frame_.leds |= (uint8_t)(1u << i);
+    countRequested(1);
+  }
+
+  void ledOff(uint8_t i) {
+    frame_.touched |= (uint8_t)(1u << i);
+    frame_.leds &= (uint8_t)~(1u << i);
+    countRequested(1);
+  }
+
+  void ledsOff() {
+    frame_.touched = 0xFF;
+    frame_.leds = 0;
+    countRequested(leds_.count());
+  }
+
+  void ledsAllOn() {
+    frame_.touched = 0xFF;
+    frame_.leds = 0xFF;
+    countRequested(leds_.count());
+  }
+
+  void click(uint8_t color) {
+    frame_.click = color;
+  }
+
+  // Aplica frame_: los LEDs que cambiaron y el click. Antes de bloquear
+  // (delay, melodías) para que se vea lo pedido hasta ahí.
+  void commitOutputs() {
+    if (frame_.touched) {
+      uint8_t n = leds_.apply(frame_.touched, frame_.leds);
+#ifdef SIMON_HOST
+      outputStats_.written += n;
+#else
+      (void)n;
+#endif
+      frame_.touched = 0;
+    }
+    if (frame_.click != kNoClick) {
+      buzzer_.click(frame_.click);
+      frame_.click = kNoClick;
+    }
+  }
+
+  void countRequested(uint8_t n) {
+#ifdef SIMON_HOST
+    outputStats_.requested += n;
+#else
+    (void)n;
+#endif
+  }
+
+  // Una grabación que no llega a GAME_OVER (hecha con otro antirrebote u
+  // otros tiempos, o que nunca arranca la partida) no puede dejar el juego
+  // sin botones reales para siempre. Mientras se muestra el patrón o se
+  // espera el tiempo límite de respuesta todavía puede terminar sola.
+  void checkReplay(Instant now) {
+    if (state_ == State::GAME_OVER || state_ == State::SHOW_PATTERN) return;
+    unsigned long limit = (unsigned long)timing_.inputTimeoutMs + kReplayTailMs;
+    if (replay_->started()) {
+      if (!replay_->finished() || now.ms() - replay_->endMs() < limit) return;
+      if (now.since(lastChange_).ms < limit) return;
+    } else if (armed_ || now.since(replayAt_).ms < limit) {
+      return;
+    }
+    replay_ = nullptr;
+  }
+
+  void changeState(State s, Instant now) {
+    TRACE_INSTANT(stateName(s));
+    state_ = s;
+    pressing_ = false;
+    lastChange_ = now;
+    if (s == State::GAME_OVER) {
+      if (difficulty_) difficulty_->gameEnd(level_);
+      if (usage_ && !replay_) usage_->gameEnd(level_, won_, won_ ? UsageStats::kNoMiss : missed_);
+      if (recorder_) recorder_->endGame(won_, (uint8_t)score_);
+      replay_ = nullptr;
+    }
+  }
+
+  void newGame(uint32_t seed, uint8_t players, Instant now) {
+    armed_ = false;
+    ledsOff();
+    if (replay_ && !replay_->started()) replay_->beginGame(now.ms());
+    if (recorder_) recorder_->beginGame(seed, now.ms());
+    won_ = false;
+    if (difficulty_) {
+      timing_ = difficulty_->timing();
+      winScore_ = difficulty_->winScore();
+    }
+    if (players_) players_->start(seed, players);
+    if (hotSeat()) {
+      display_.showPlayers(*players_);
+      loadTurn();
+    } else {
+      pm_.reset(seed);
+      level_ = 1;
+      score_ = 0;
+      pm_.template addRound<Mode>();
+    }
+    beginRound(now);
+  }
+
+  // Un botón arranca la partida, pero recién kChordMs después: si en ese
+  // tiempo se forma el acorde de ajustes se abre el menú en su lugar
+  void handleIdle(Instant now) {
+    TRACE_SCOPE("GameController::handleIdle");
+    if (buttons_.chord() == kSettingsChord) {
+      disarm();
+      enterSettings(now);
+      return;
+    }
+    if (usage_ && buttons_.chord() == kStatsChord) {
+      disarm();
+      ledsOff();
+      statsPage_ = 0;
+      display_.showUsage(statsPage_, *usage_);
+      changeState(State::STATS, now);
+      return;
+    }
+    if (!armed_) {
+      uint8_t btn = buttons_.anyRisingEdge();
+      if (btn == 0xFF) return;
+      armed_ = true;
+      armedBtn_ = btn;
+      armedAt_ = now;
+      // la grabación y la reproducción cuentan desde este toque: si se
+      // suelta antes de kChordMs, el soltar también queda grabado
+      if (recorder_) recorder_->arm(now.ms());
+      if (replay_) replay_->beginGame(now.ms());
+    }
+    if (now.since(armedAt_).ms < Buttons::kChordMs) return;
+    // con hot seat el botón elige cuántos juegan
+    newGame(replay_ ? replay_->seed() : pm_.newSeed(), players_ ? armedBtn_ + 1 : 1, now);
+  }
+
+  void disarm() {
+    if (armed_ && recorder_) recorder_->cancel();
+    armed_ = false;
+  }
+
+  void enterSettings(Instant now) {
+    ledsOff();
+    settingsItem_ = kItemSpeed;
+    showSettingItem();
+    changeState(State::SETTINGS, now);
+  }
+
+  // Botón 1: siguiente opción; 2 y 3: menos y más; 3 largo: borrar el
+  // récord; doble 4 o 30 s sin tocar nada: salir
+  void handleSettings(Instant now) {
+    TRACE_SCOPE("GameController::handleSettings");
+    if (buttons_.doublePress(3) || now.since(lastChange_).ms >= kSettingsIdleMs) {
+      display_.showPressToStart();
+      changeState(State::IDLE, now);
+      return;
+    }
+    if (settingsItem_ == kItemReset && buttons_.longPress(2)) {
+      highScore_ = 0;
+      settingsChanged_ = true;
+      buzzer_.beep(150, 1500);
+      display_.showSetting("Borrar record", 0, "Borrado");
+      lastChange_ = now;
+      return;
+    }
+
+    uint8_t btn = buttons_.anyRisingEdge();
+    if (btn == 0xFF || btn == 3) return;
+    lastChange_ = now;
+    if (settingsItem_ == kItemCalibrate && btn == 2) {
+      enterCalibrate(now);
+      return;
+    }
+    if (btn == 0) {
+      settingsItem_ = (uint8_t)((settingsItem_ + 1) % kItems);
+      if (settingsItem_ == kItemCalibrate && !calibrator_) settingsItem_ = 0;
+    } else {
+      changeSetting(btn == 2 ? 1 : -1);
+    }
+    showSettingItem();
+  }
+
+  // Cualquier botón pasa de página; después de la última, o a los
+  // kStatsIdleMs, vuelve a IDLE
+  void handleStats(Instant now) {
+    TRACE_SCOPE("GameController::handleStats");
+    bool next = buttons_.anyRisingEdge() != 0xFF;
+    if (next && ++statsPage_ < kStatsPages) {
+      display_.showUsage(statsPage_, *usage_);
+      lastChange_ = now;
+    } else if (next || now.since(lastChange_).ms >= kStatsIdleMs) {
+      display_.showPressToStart();
+      changeState(State::IDLE, now);
+    }
+  }
+
+  void enterCalibrate(Instant now) {
+    calibrator_->begin(buttons_.readPins(), micros());
+    uint8_t zeros[4] = {0, 0, 0, 0};
+    display_.showButtonValues("Toque c/boton", zeros, leds_.count());
+    changeState(State::CALIBRATE, now);
+  }
+
+  // Los niveles crudos van al calibrador; los botones no manejan el menú
+  // hasta que termina (o pasa kCalibrateMs). El calibrador sigue con
+  // micros(): mide rebotes de menos de un ms.
+  void handleCalibrate(uint8_t levels, Instant now) {
+    TRACE_SCOPE("GameController::handleCalibrate");
+    uint8_t closed = calibrator_->sample(levels, micros());
+    if (closed != 0xFF) display_.showButtonValue(closed, calibrator_->samples(closed));
+
+    if (calibrator_->done()) {
+      uint8_t ms[4];
+      for (uint8_t i = 0; i < leds_.count(); ++i) {
+        ms[i] = calibrator_->window(i);
+        buttons_.setDebounce(i, ms[i]);
+      }
+      settingsChanged_ = true;
+      buzzer_.beep(150, 1500);
+      display_.showButtonValues("Antirrebote ms", ms, leds_.count());
+      changeState(State::SETTINGS, now);
+    } else if (now.since(lastChange_).ms >= kCalibrateMs) {
+      showSettingItem();
+      changeState(State::SETTINGS, now);
+    }
+  }
+
+  void changeSetting(int8_t delta) {
+    switch (settingsItem_) {
+      case kItemSpeed: {
+        int s = speed() + delta;
+        if (s < kSpeedMin || s > kSpeedMax) return;
+        setSpeed((uint8_t)s);
+        break;
+      }
+      case kItemSound:
+        setSound(!sound());
+        break;
+      case kItemColors: {
+        int n = pm_.colors() + delta;
+        if (n < kColorsMin || n > leds_.count()) return;
+        pm_.setColors((uint8_t)n);
+        break;
+      }
+      default:
+        return;
+    }
+    settingsChanged_ = true;
+  }
+
+  void showSettingItem() {
+    switch (settingsItem_) {
+      case kItemSpeed:
+        display_.showSetting("Velocidad", speed());
+        break;
+      case kItemSound:
+        display_.showSetting("Volumen", 0, sound() ? "Con sonido" : "Sin sonido");
+        break;
+      case kItemColors:
+        display_.showSetting("Colores", pm_.colors());
+        break;
+      case kItemReset:
+        display_.showSetting("Borrar record", 0, "Mantener boton 3");
+        break;
+      default:
+        display_.showSetting("Calibrar botones", 0, "Boton 3: empezar");
+        break;
+    }
+  }
+
+  // Primera ronda o siguiente: con la compuerta puesta queda esperando
+  // a openRound() antes de mostrar el patrón
+  void beginRound(Instant now) {
+    indexPattern_ = 0;
+    ledOn_ = false;
+    roundOpen_ = !gate_;
+    if (hotSeat()) display_.showTurn(players_->turn, level_);
+    else display_.showLevel(level_, highScore_);
+    changeState(State::SHOW_PATTERN, now);
+    if (Periph::kNonBlocking) lastChange_ = now + msecs(kLevelLeadMs);
+  }
+
+  // Hot seat: el patrón del jugador de turno se regenera desde su semilla
+  void loadTurn() {
+    const PlayerSlot& p = players_->slot[players_->turn];
+    level_ = p.level;
+    score_ = p.score;
+    pm_.reset(p.seed);
+    for (uint8_t i = 0; i < level_; ++i) pm_.template addRound<Mode>();
+  }
+
+  // Guarda el turno que terminó y le pasa al próximo; false si no queda nadie
+  bool nextTurn(bool failed, Instant now) {
+    PlayerSlot& p = players_->slot[players_->turn];
+    p.score = (uint8_t)score_;
+    p.level = level_;
+    p.out = failed;
+    display_.showPlayerScore(players_->turn, p);
+    if (!players_->advance()) return false;
+    loadTurn();
+    beginRound(now);
+    return true;
+  }
+
+  void handleShowPattern(Instant now) {
+    TRACE_SCOPE("GameController::handleShowPattern");
+    if (!roundOpen_) return;
+
+    if (indexPattern_ >= pm_.length()) {
+      ledsOff();
+      indexInput_ = 0;
+      changeState(State::WAIT_INPUT, now);
+      return;
+    }
+
+    if (!ledOn_) {
+      // pausa entre pasos: lastChange_ quedó en el momento de volver a prender
+      if (!now.reached(lastChange_)) return;
+      uint8_t ledIdx = pm_.getStep(indexPattern_);
+      ledsOff();
+      ledOn(ledIdx);
+      click(ledIdx);
+      ledOn_ = true;
+      lastChange_ = now;
+    } else {
+      if (now.since(lastChange_).ms >= Mode::onMs(timing_, level_)) {
+        ledsOff();
+        ledOn_ = false;
+        lastChange_ = now + msecs(Mode::offMs(timing_, level_));
+        ++indexPattern_;
+      }
+    }
+  }
+
+  void handleWaitInput(Instant now) {
+    TRACE_SCOPE("GameController::handleWaitInput");
+    if (Periph::kNonBlocking && pressing_) {
+      // los botones no cuentan hasta que se apaga el LED, como con delay()
+      if (!now.reached(armedAt_)) return;
+      pressing_ = false;
+      ledOff(armedBtn_);
+      Instant pressedAt = armedAt_ - msecs(kPressMs);
+      checkPress(armedBtn_, pressedAt.since(lastChange_).ms, now);
+      return;
+    }
+
+    uint8_t btn = buttons_.anyRisingEdge();
+    if (btn == 0xFF) {
+      if (timing_.inputTimeoutMs &&
+          now.since(lastChange_).ms >= timing_.inputTimeoutMs) {
+        lose();
+      }
+      return;
+    }
+
+    unsigned long reaction = now.since(lastChange_).ms;
+    ledOn(btn);
+    click(btn);
+    if (Periph::kNonBlocking) {
+      pressing_ = true;
+      armedBtn_ = btn;
+      armedAt_ = now + msecs(kPressMs);
+      return;
+    }
+    commitOutputs();
+    delay(kPressMs);
+    ledOff(btn);
+    // el delay() corrió el reloj: el tiempo para responder el próximo paso
+    // cuenta desde acá
+    checkPress(btn, reaction, Clock::now());
+  }
+
+  // El botón btn ya se mostró: acierto o error
+  void checkPress(uint8_t btn, unsigned long reaction, Instant now) {
+    if (btn == pm_.getStep(Mode::expected(indexInput_, pm_.length()))) {
+      if (difficulty_) difficulty_->press(reaction);
+      ++indexInput_;
+      lastChange_ = now;
+      if (indexInput_ >= pm_.length()) {
+        // ronda completa
+        score_ = pm_.length();
+        if (score_ > highScore_) {
+          highScore_ = score_;
+        }
+
+        if (difficulty_) {
+          difficulty_->roundEnd(true, 0, pm_.length());
+          timing_ = difficulty_->timing();
+        }
+
+        // ganó?
+        if (score_ >= winScore_) {
+          won_ = true;
+          commitOutputs();
+          buzzer_.success();
+          display_.showWin(score_, highScore_);
+          if (hotSeat()) display_.showPlayerTag(players_->turn);
+          changeState(State::GAME_OVER, now);
+          return;
+        }
+
+        level_++;
+        if (hotSeat()) {
+          nextTurn(false, now);
+          return;
+        }
+        pm_.template addRound<Mode>();
+        beginRound(now);
+      }
+    } else {
+      lose();
+    }
+  }
+
+  // Falló (o se le acabó el tiempo)
+  void lose() {
+    won_ = false;
+    missed_ = pm_.getStep(Mode::expected(indexInput_, pm_.length()));
+    commitOutputs();
+    buzzer_.fail();
+    // la melodía puede bloquear: el estado nuevo empieza cuando termina
+    Instant now = Clock::now();
+    if (difficulty_) {
+      difficulty_->roundEnd(false, indexInput_, pm_.length());
+      timing_ = difficulty_->timing();
+    }
+    if (hotSeat()) {
+      // sigue el próximo; si perdieron todos, gana el de más puntos
+      if (nextTurn(true, now)) return;
+      uint8_t b = players_->best();
+      score_ = players_->slot[b].score;
+      display_.showGameOver(score_, highScore_);
+      display_.showPlayerTag(b);
+    } else {
+      display_.showGameOver(score_, highScore_);
+    }
+    changeState(State::GAME_OVER, now);
+  }
+
+  void handleGameOver(Instant now) {
+    TRACE_SCOPE("GameController::handleGameOver");
+
+    // Parpadeo distinto si ganó o perdió
+    if (won_) {
+      // Parpadeo más lento
+      if ((now.ms() / 400) % 2 == 0) {
+        ledsAllOn();
+      } else {
+        ledsOff();
+      }
+    } else {
+      // Parpadeo rápido de "fail"
+      if ((now.ms() / 200) % 2 == 0) {
+        ledsAllOn();
+      } else {
+        ledsOff();
+      }
+    }
+
+    // Pulsar cualquier botón para volver a IDLE
+    if (buttons_.anyRisingEdge() != 0xFF) {
+      ledsOff();
+      display_.showPressToStart();
+      changeState(State::IDLE, now);
+    }
+  }
+};
+
+// El juego que usa el sketch: clásico salvo que se compile con, por
+// ejemplo, -DSIMON_MODE=ReverseMode
+typedef BasicGameController<SIMON_MODE> GameController;
@@ -0,0 +1,24 @@
+#pragma once
+
+// Tamaños en tiempo de compilación. Compilando con -DSIMON_SIZE_REPORT cada
+// SIMON_REPORT_SIZE(T) deja un aviso del compilador con sizeof(T), p. ej.:
+//
+//   warning: 'constexpr bool sizeReport() [with T = PlayerSlot;
+//             unsigned int Bytes = N]' is deprecated
+//
+// Sin la opción no genera nada. Los tamaños son los del compilador que
+// se use: los de la placa solo compilando el sketch para el AVR (esa
+// compilación no está en CMakeLists.txt); los de la PC sirven para
+// comparar, sin tener que leer el .map.
+
+#include <stddef.h>
+
+#ifdef SIMON_SIZE_REPORT
+template <typename T, size_t Bytes = sizeof(T)>
+[[deprecated("informe de tamaño (SIMON_SIZE_REPORT)")]]
+constexpr bool sizeReport() { return true; }
+
+#define SIMON_REPORT_SIZE(T) static_assert(sizeReport<T>(), #T)
+#else
+#define SIMON_REPORT_SIZE(T) static_assert(true, #T)
+#endif
@@ -0,0 +1,19 @@
+#include "StackPaint.h"
+
+#ifdef __AVR__
+// En .init1 r1 todavía no vale cero: en ensamblador, sin usar la pila
+static void stackPaint() __attribute__((naked, used, section(".init1")));
+static void stackPaint() {
+  __asm volatile(
+    "    ldi r30, lo8(_end)\n"
+    "    ldi r31, hi8(_end)\n"
+    "    ldi r24, 0xC5\n"          // STACK_CANARY
+    "    ldi r25, hi8(__stack)\n"
+    "    rjmp 2f\n"
+    "1:  st Z+, r24\n"
+    "2:  cpi r30, lo8(__stack)\n"
+    "    cpc r31, r25\n"
+    "    brlo 1b\n"
+    "    breq 1b\n");
+}
+#endif
@@ -0,0 +1,90 @@
+#pragma once
+
+// Cuánta pila llegó a usar el sketch. Al arrancar se pinta toda la RAM
+// libre (entre el final de .bss y el tope de la pila) con STACK_CANARY; lo
+// que la pila pisa deja de tenerlo. Contando desde abajo los bytes que
+// siguen pintados se sabe cuánto margen quedó en el peor momento. No hay
+// heap (el sketch no usa malloc ni String), así que nada más escribe ahí.
+//
+// En el AVR se pinta solo en .init1, antes de los constructores
+// (StackPaint.cpp). En la PC hay que llamar a stackPaint() al principio de
+// setup(): pinta una ventana de hasta kStackWindow bytes debajo de ese
+// punto, dentro de la pila del hilo, y mide cuánto bajan de ahí las
+// llamadas siguientes (los tamaños no son los del AVR, sirve para
+// comparar).
+//
+// Contar recorre el margen entero (casi toda la RAM libre): es para la
+// consola, no para cada pasada de loop().
+
+#include <Arduino.h>
+#ifndef __AVR__
+#include <pthread.h>
+#endif
+
+const uint8_t STACK_CANARY = 0xC5;
+
+#ifdef __AVR__
+extern uint8_t _end;
+extern uint8_t __stack;
+
+// El pintado está en StackPaint.cpp (.init1), una sola vez para todo el
+// sketch
+
+inline uint8_t* stackBottom() { return &_end; }
+inline uint16_t stackSize() { return (uint16_t)(&__stack - &_end + 1); }
+
+// .data + .bss
+inline uint16_t staticRam() { return (uint16_t)((uint16_t)&_end - RAMSTART); }
+#else
+const uint16_t kStackWindow = 16384;
+
+inline uint8_t*& stackWindowBottom() {
+  static thread_local uint8_t* bottom = nullptr;
+  return bottom;
+}
+
+inline uint16_t& stackWindowSize() {
+  static thread_local uint16_t size = 0;
+  return size;
+}
+
+// Solo dentro de la pila del hilo (pthread_getattr_np), sin la página de
+// guarda: si no hay kStackWindow bytes libres la ventana es más chica
+__attribute__((noinline)) inline void stackPaint() {
+  pthread_attr_t attr;
+  void* addr;
+  size_t size;
+  size_t guard = 0;
+  if (pthread_getattr_np(pthread_self(), &attr)) return;
+  bool ok = !pthread_attr_getstack(&attr, &addr, &size);
+  pthread_attr_getguardsize(&attr, &guard);
+  pthread_attr_destroy(&attr);
+  if (!ok) return;
+  // un margen para el marco de esta función
+  uint8_t* top = (uint8_t*)__builtin_frame_address(0) - 512;
+  uint8_t* limit = (uint8_t*)addr + guard + 4096;
+  if (top <= limit) return;
+  uint8_t* bottom = top - limit < kStackWindow ? limit : top - kStackWindow;
+  for (volatile uint8_t* p = bottom; p < top; ++p) *p = STACK_CANARY;
+  stackWindowBottom() = bottom;
+  stackWindowSize() = (uint16_t)(top - bottom);
+}
+
+inline uint8_t* stackBottom() { return stackWindowBottom(); }
+inline uint16_t stackSize() { return stackWindowSize(); }
+inline uint16_t staticRam() { return 0; }
+#endif
+
+// Bytes que la pila nunca tocó desde que se pintó
+inline uint16_t stackHeadroom() {
+  const volatile uint8_t* p = stackBottom();
+  uint16_t n = 0;
+  uint16_t size = stackSize();
+  while (n < size && p[n] == STACK_CANARY) ++n;
+  return n;
+}
+
+// Lo más que llegó a ocupar
+inline uint16_t stackPeak() {
+  return (uint16_t)(stackSize() - stackHeadroom());
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+// Varias estaciones de Simon en un solo MCU (una Mega, SIMON_STATIONS en
+// Pins.h; el sketch es stations.cpp). Cada BasicGameStation tiene sus
+// periféricos, su GameController, su modo de atracción, sus estadísticas
+// de uso y su lugar en la EEPROM (Config.h). Todas comparten el reloj (un
+// Instant por pasada), el Scheduler, la cola de la EEPROM y el ToneEngine,
+// donde cada una tiene su Voice.
+//
+// Con SharedPeripherals el GameController no bloquea (kNonBlocking) y las
+// melodías no esperan, así que una pasada cuesta lo mismo por estación y
+// el total crece lineal con la cantidad. El LCD tampoco bloquea: cada
+// estación escribe en su LcdBuffer y flush() manda unas pocas
+// transferencias por pasada.
+
+#include <Arduino.h>
+#include <LiquidCrystal.h>
+#include "Pins.h"
+#include "Simon.h"
+#include "ToneEngine.h"
+#include "Scheduler.h"
+#include "Attract.h"
+#include "Config.h"
+#include "LcdBuffer.h"
+
+struct SharedPeripherals : ArduinoPeripherals {
+  typedef Voice Sound;
+  typedef BasicDisplayLCD<LcdBuffer> Display;
+  static const bool kNonBlocking = true;
+};
+
+// Costo de cada estación dentro de loop()
+struct StationStats {
+  uint32_t passes;
+  uint32_t busyUs;
+  uint16_t maxUs;           // la pasada más larga
+};
+
+template <typename Mode = SIMON_MODE, typename Periph = SharedPeripherals>
+class BasicGameStation {
+public:
+  typedef BasicGameController<Mode, Periph> Game;
+
+  LiquidCrystal               lcd;
+  LcdBuffer                   screen;
+  typename Periph::Leds       leds;
+  typename Periph::Buttons    buttons;
+  typename Periph::Sound      voice;
+  typename Periph::Display    display;
+  typename Periph::Pattern    pattern;
+  Game                        game;
+  UsageStats                  usage;
+  BasicAttractMode<Game>      attract;
+
+  BasicGameStation(const StationPins& p, Scheduler& sched)
+    : lcd(p.lcd[0], p.lcd[1], p.lcd[2], p.lcd[3], p.lcd[4], p.lcd[5]),
+      screen(lcd),
+      leds(p.leds, 4),
+      buttons(p.buttons, 4, 25),
+      voice(p.buzzer),
+      display(screen),
+      pattern(4, 50),
+      game(pattern, leds, buttons, voice, display),
+      attract(sched, game, leds, voice, display),
+      index_(0) {
+    resetStats();
+  }
+
+  // index: lugar en la EEPROM
+  void begin(uint8_t index, ToneEngine& audio) {
+    index_ = index;
+    game.setUsage(&usage);
+    leds.begin();
+    buttons.begin();
+    voice.begin();
+    audio.add(voice);
+    game.begin();
+    SimonConfig config;
+    if (loadConfig(config, index_)) applyConfig(config, game, buttons);
+    loadUsage(usage, index_);
+    attract.begin();
+  }
+
+  void loop(Instant now, EepromQueue& q) {
+    unsigned long t0 = micros();
+    voice.tick(now);
+    game.loop(now);
+    // con la cola llena (la comparten todas) se reintenta, como en main.cpp
+    if (game.takeSettingsChanged()) configSave_.request();
+    configSave_.update(game, buttons, q, now, index_);
+    if (usage.dirty()) saveUsage(usage, q, now, index_);
+    attract.update(now);
+    screen.flush();
+    unsigned long us = micros() - t0;
+    ++stats_.passes;
+    stats_.busyUs += us;
+    if (us > stats_.maxUs) stats_.maxUs = us > 0xFFFF ? 0xFFFF : (uint16_t)us;
+  }
+
+  const StationStats& stats() const { return stats_; }
+
+  void resetStats() {
+    stats_.passes = 0;
+    stats_.busyUs = 0;
+    stats_.maxUs = 0;
+  }
+
+private:
+  uint8_t index_;
+  ConfigSave configSave_;
+  StationStats stats_;
+};
+
+typedef BasicGameStation<> GameStation;
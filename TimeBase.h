@@ -0,0 +1,93 @@
+#pragma once
+
+// Tiempo del sketch con tipos: Duration (cuánto) e Instant (cuándo), en ms.
+// millis() da la vuelta a los 49 días; las cuentas de siempre
+// (`now - last >= ms`, `(long)(now - t) < 0`) funcionan solo si se
+// escriben justo así. Acá son las únicas operaciones que hay:
+//
+//   now.since(t)        tiempo desde t (sirve aunque millis() haya dado
+//                       la vuelta entre medio)
+//   now.reached(t)      ya llegó t (t puede estar en el futuro: t = now + d)
+//   t + d               instante d después de t
+//
+// No hay < entre instantes, que es justo la comparación que se rompe con
+// la vuelta. Todo es constexpr y se compila a las mismas restas.
+//
+// BasicInstant<uint16_t> (ShortInstant) ocupa la mitad y da la vuelta a
+// los 65 s: sirve para intervalos de menos de 32 s.
+//
+// Clock::now() lee millis() (que en el AVR apaga las interrupciones para
+// leer los 32 bits): loop() lo lee una vez por pasada y se lo pasa a todos.
+
+#include <Arduino.h>
+
+// T si B, F si no (el avr-gcc no trae <type_traits>)
+template <bool B, typename T, typename F> struct PickType { typedef T type; };
+template <typename T, typename F> struct PickType<false, T, F> { typedef F type; };
+
+template <typename Rep>
+struct BasicDuration {
+  Rep ms;
+
+  constexpr bool operator==(BasicDuration o) const { return ms == o.ms; }
+  constexpr bool operator!=(BasicDuration o) const { return ms != o.ms; }
+  constexpr bool operator<(BasicDuration o) const { return ms < o.ms; }
+  constexpr bool operator>=(BasicDuration o) const { return ms >= o.ms; }
+  constexpr BasicDuration operator+(BasicDuration o) const { return BasicDuration{(Rep)(ms + o.ms)}; }
+};
+
+template <typename Rep>
+class BasicInstant {
+public:
+  typedef BasicDuration<Rep> Duration;
+  // con signo y del mismo ancho, para saber de qué lado quedó un instante
+  typedef typename PickType<sizeof(Rep) == 2, int16_t, int32_t>::type Signed;
+
+  constexpr BasicInstant() : ms_(0) {}
+
+  static constexpr BasicInstant fromMs(unsigned long ms) { return BasicInstant((Rep)ms); }
+
+  // Los 16 bits de abajo de un instante largo
+  template <typename Wide>
+  static constexpr BasicInstant from(BasicInstant<Wide> t) { return BasicInstant((Rep)t.ms()); }
+
+  constexpr Rep ms() const { return ms_; }
+
+  constexpr Duration since(BasicInstant earlier) const {
+    return Duration{(Rep)(ms_ - earlier.ms_)};
+  }
+
+  constexpr bool reached(BasicInstant t) const {
+    return (Signed)(Rep)(ms_ - t.ms_) >= 0;
+  }
+
+  constexpr BasicInstant operator+(Duration d) const { return BasicInstant((Rep)(ms_ + d.ms)); }
+  constexpr BasicInstant operator-(Duration d) const { return BasicInstant((Rep)(ms_ - d.ms)); }
+  constexpr bool operator==(BasicInstant o) const { return ms_ == o.ms_; }
+  constexpr bool operator!=(BasicInstant o) const { return ms_ != o.ms_; }
+
+private:
+  Rep ms_;
+
+  constexpr explicit BasicInstant(Rep ms) : ms_(ms) {}
+};
+
+typedef BasicDuration<uint32_t> Duration;
+typedef BasicInstant<uint32_t> Instant;
+typedef BasicDuration<uint16_t> ShortDuration;
+typedef BasicInstant<uint16_t> ShortInstant;
+
+constexpr Duration msecs(uint32_t ms) { return Duration{ms}; }
+
+struct Clock {
+  static Instant now() { return Instant::fromMs(millis()); }
+};
+
+static_assert(Instant::fromMs(0xFFFFFFF0UL).reached(Instant::fromMs(0xFFFFFFF0UL) + msecs(0)),
+              "un instante se alcanza a sí mismo");
+static_assert((Instant::fromMs(0xFFFFFFF0UL) + msecs(0x20)).reached(Instant::fromMs(0xFFFFFFF0UL)),
+              "reached() tiene que sobrevivir a la vuelta");
+static_assert(!Instant::fromMs(0xFFFFFFF0UL).reached(Instant::fromMs(0xFFFFFFF0UL) + msecs(0x20)),
+              "un instante futuro no se alcanzó");
+static_assert(ShortInstant::fromMs(5).since(ShortInstant::fromMs(0xFFFB)).ms == 10,
+              "since() con 16 bits");
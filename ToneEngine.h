@@ -0,0 +1,208 @@
+#pragma once
+
+// Un solo generador de tono para varias estaciones (Stations.h). tone()
+// usa el Timer2 y suena en un pin por vez, así que cada estación tiene una
+// Voice con su pin y los mismos métodos que Buzzer, pero sin bloquear: las
+// notas van a una cola y ToneEngine::update() las toca desde loop().
+//
+// Primero suenan los clicks (la respuesta a un botón) y después las demás
+// notas; entre voces, por turno. Si otra voz está esperando, la nota que
+// suena se corta a los kSliceMs: así ninguna espera más que un turno
+// corto de cada una de las otras. Un click que esperó más de kMaxWaitMs
+// se descarta (tarde confunde más que uno que no suena); una melodía solo
+// se corre, y recién pasado kMaxMelodyWaitMs se descarta la nota (tres
+// melodías de victoria a la vez la atrasan ~400 ms). Con kMaxVoices
+// estaciones jugando no debería pasar ninguna de las dos cosas:
+// simon_stations_bench falla si alguna voz descartó algo. Cada voz cuenta
+// lo que tocó y lo que se descartó.
+//
+// La cola es un IsrRing (IsrShared.h): el motor podría pasar a una
+// interrupción de timer sin cambiar las voces.
+
+#include <Arduino.h>
+#include "TimeBase.h"
+#include "IsrShared.h"
+#include "Simon.h"
+
+struct Note {
+  uint16_t freq;            // 0 = silencio
+  uint16_t ms;
+  ShortInstant dueAt;       // al anotarla, o al terminar las anteriores de la voz
+  bool click;               // va antes que las demás
+};
+
+class Voice {
+public:
+  static const uint8_t kQueue = 8;
+
+  explicit Voice(uint8_t pin)
+    : pin_(pin), sound_(true), flush_(false), played_(0), dropped_(0) {}
+
+  void begin() {
+    pinMode(pin_, OUTPUT);
+    digitalWrite(pin_, LOW);
+  }
+
+  // Al principio de cada pasada: el instante con que se anotan las notas
+  void tick(Instant now) {
+    now_ = ShortInstant::from(now);
+  }
+
+  void beep(uint16_t ms, unsigned int freq) {
+    if (sound_) queue((uint16_t)freq, ms, false);
+  }
+
+  void click(uint8_t idx) {
+    if (sound_ && idx < 4) queue((uint16_t)Buzzer::clickFreq(idx), 120, true);
+  }
+
+  // Las de Buzzer, donde cada beep() corta al anterior: cada nota dura
+  // hasta la siguiente
+  void success() {
+    beep(50, 1500);
+    beep(50, 1800);
+    beep(200, 2000);
+  }
+
+  void fail() {
+    beep(100, 300);
+    beep(250, 200);
+  }
+
+  // Corta lo que suena y descarta lo que espera (en el próximo update())
+  void stop() {
+    flush_ = true;
+    free_ = now_;
+  }
+
+  void setSound(bool on) {
+    sound_ = on;
+    if (!on) stop();
+  }
+
+  bool sound() const { return sound_; }
+  uint8_t pin() const { return pin_; }
+  uint32_t played() const { return played_; }
+  uint32_t dropped() const { return dropped_; }
+
+private:
+  friend class ToneEngine;
+
+  IsrRing<Note, kQueue> notes_;
+  uint8_t pin_;
+  ShortInstant now_;
+  ShortInstant free_;       // cuándo terminan las notas anotadas
+  bool sound_;
+  bool flush_;
+  uint32_t played_;
+  uint32_t dropped_;        // por cola llena o por esperar demasiado
+
+  void queue(uint16_t freq, uint16_t ms, bool click) {
+    Note n;
+    n.freq = freq;
+    n.ms = ms;
+    // las notas seguidas de una voz (success(), fail()) son una melodía:
+    // cada una llega tarde recién si no sonó cuando terminaba la anterior
+    n.dueAt = now_.reached(free_) ? now_ : free_;
+    free_ = n.dueAt + ShortDuration{ms};
+    n.click = click;
+    if (!notes_.push(n)) ++dropped_;
+  }
+};
+
+class ToneEngine {
+public:
+  static const uint8_t kMaxVoices = 4;
+  static const uint16_t kMaxWaitMs = 200;        // un click
+  static const uint16_t kMaxMelodyWaitMs = 1000;  // las demás notas
+  static const uint16_t kSliceMs = 50;          // con otra voz esperando
+  static const uint8_t kNone = 0xFF;
+
+  ToneEngine() : count_(0), current_(kNone) {}
+
+  // false si no hay lugar
+  bool add(Voice& v) {
+    if (count_ == kMaxVoices) return false;
+    voices_[count_++] = &v;
+    return true;
+  }
+
+  // En cada pasada: la nota que sigue, si terminó la anterior
+  void update(Instant now) {
+    for (uint8_t i = 0; i < count_; ++i) {
+      Voice& v = *voices_[i];
+      if (!v.flush_) continue;
+      v.flush_ = false;
+      Note n;
+      while (v.notes_.pop(n)) {}
+      if (current_ == i) {
+        noTone(v.pin_);
+        current_ = kNone;
+      }
+    }
+    if (current_ != kNone && !now.reached(until_) &&
+        !(now.reached(started_ + msecs(kSliceMs)) && othersWaiting())) {
+      return;
+    }
+
+    ShortInstant t = ShortInstant::from(now);
+    for (;;) {
+      uint8_t i = next(t);
+      if (i == kNone) return;
+      Voice& v = *voices_[i];
+      Note n;
+      if (!v.notes_.pop(n)) return;
+      if (late(t, n) > (n.click ? kMaxWaitMs : kMaxMelodyWaitMs)) {
+        ++v.dropped_;
+        continue;
+      }
+      // tone() no cambia de pin mientras suena otro
+      if (current_ != kNone && current_ != i) noTone(voices_[current_]->pin_);
+      if (n.freq) tone(v.pin_, n.freq, n.ms);
+      else noTone(v.pin_);
+      ++v.played_;
+      current_ = i;
+      started_ = now;
+      until_ = now + msecs(n.ms);
+      return;
+    }
+  }
+
+  // Voz que está sonando (kNone si ninguna)
+  uint8_t current() const { return current_; }
+
+private:
+  Voice* voices_[kMaxVoices];
+  uint8_t count_;
+  uint8_t current_;
+  Instant started_;
+  Instant until_;
+
+  static uint16_t late(ShortInstant t, const Note& n) {
+    return t.reached(n.dueAt) ? t.since(n.dueAt).ms : 0;
+  }
+
+  bool othersWaiting() const {
+    for (uint8_t i = 0; i < count_; ++i) {
+      if (i != current_ && !voices_[i]->notes_.empty()) return true;
+    }
+    return false;
+  }
+
+  // Por turno desde la voz que sigue a la actual (la actual, última): la
+  // primera con un click adelante o con una nota que ya esperó la mitad de
+  // kMaxWaitMs (los clicks no la dejan sin sonar), o si no la primera con
+  // notas
+  uint8_t next(ShortInstant t) const {
+    uint8_t from = current_ == kNone ? 0 : (uint8_t)(current_ + 1);
+    uint8_t other = kNone;
+    for (uint8_t k = 0; k < count_; ++k) {
+      uint8_t i = (uint8_t)((from + k) % count_);
+      Note n;
+      if (!voices_[i]->notes_.peek(n)) continue;
+      if (n.click || late(t, n) >= kMaxWaitMs / 2) return i;
+      if (other == kNone) other = i;
+    }
+    return other;
+  }
+};
@@ -0,0 +1,16 @@
+#pragma once
+
+// Marcas de traza para ver la línea de tiempo del juego en el simulador.
+// En el Arduino no generan código; en la PC (SIMON_HOST) van al grabador
+// de host/TraceRecorder.h.
+
+#ifdef SIMON_HOST
+#include "host/TraceRecorder.h"
+#define TRACE_CAT2(a, b) a##b
+#define TRACE_CAT(a, b) TRACE_CAT2(a, b)
+#define TRACE_SCOPE(name) trace::Scope TRACE_CAT(traceScope_, __LINE__)(name)
+#define TRACE_INSTANT(name) trace::instant(name)
+#else
+#define TRACE_SCOPE(name) ((void)0)
+#define TRACE_INSTANT(name) ((void)0)
+#endif
@@ -0,0 +1,109 @@
+#pragma once
+
+// Estadísticas de uso del gabinete: partidas jugadas, nivel medio al que
+// se llega, cuántas se ganan y qué color se falla más. Se actualizan una
+// vez por partida, al llegar a GAME_OVER, con un costo fijo: no se guarda
+// ninguna historia que haya que recorrer.
+//
+// El nivel medio es una media acumulada en punto fijo 8.8:
+//   media += (nivel - media) / partidas
+// (redondeada), así que no hace falta la suma de todos los niveles. Los
+// fallos van por color del paso que se esperaba; si alguno llega al tope
+// se dividen los cuatro a la mitad y la proporción entre colores se
+// mantiene.
+//
+// UsageRecord es el bloque que va a la EEPROM (Config.h lo guarda).
+
+#include <Arduino.h>
+
+struct UsageRecord {
+  uint32_t games;
+  uint32_t wins;
+  uint16_t levelMeanQ8;     // nivel medio, 8.8
+  uint16_t missed[4];       // fallos por color
+  uint8_t magic;
+  uint8_t version;
+  uint16_t seq;             // cuántas veces se grabó (Config.h)
+  uint16_t crc;             // de todos los bytes anteriores
+};
+
+static_assert(sizeof(UsageRecord) == 24, "el bloque no puede tener relleno");
+
+class UsageStats {
+public:
+  static const uint8_t kNoMiss = 0xFF;
+
+  UsageStats() : dirty_(false) {
+    memset(&rec_, 0, sizeof(rec_));
+  }
+
+  // Todo a cero (la cuenta de grabaciones sigue)
+  void reset() {
+    uint16_t seq = rec_.seq;
+    memset(&rec_, 0, sizeof(rec_));
+    rec_.seq = seq;
+    dirty_ = true;
+  }
+
+  // Al terminar cada partida; missed = color que se esperaba cuando se
+  // equivocó (kNoMiss si ganó)
+  void gameEnd(uint8_t level, bool won, uint8_t missed) {
+    ++rec_.games;
+    if (won) ++rec_.wins;
+
+    int32_t diff = ((int32_t)level << 8) - rec_.levelMeanQ8;
+    int32_t half = (int32_t)(rec_.games / 2);
+    int32_t step = (diff + (diff < 0 ? -half : half)) / (int32_t)rec_.games;
+    rec_.levelMeanQ8 = (uint16_t)(rec_.levelMeanQ8 + step);
+
+    if (missed < 4) {
+      if (rec_.missed[missed] == 0xFFFF) {
+        for (uint8_t i = 0; i < 4; ++i) rec_.missed[i] >>= 1;
+      }
+      ++rec_.missed[missed];
+    }
+    dirty_ = true;
+  }
+
+  uint32_t games() const { return rec_.games; }
+  uint32_t wins() const { return rec_.wins; }
+  uint16_t levelMeanQ8() const { return rec_.levelMeanQ8; }
+  uint16_t missed(uint8_t color) const { return rec_.missed[color]; }
+
+  // Partidas ganadas, en por ciento (0 sin partidas)
+  uint8_t winPercent() const {
+    return rec_.games ? (uint8_t)((rec_.wins * 100 + rec_.games / 2) / rec_.games) : 0;
+  }
+
+  // Color que más se falla (kNoMiss si todavía no se falló nada)
+  uint8_t mostMissed() const {
+    uint8_t best = kNoMiss;
+    uint16_t most = 0;
+    for (uint8_t i = 0; i < 4; ++i) {
+      if (rec_.missed[i] > most) {
+        most = rec_.missed[i];
+        best = i;
+      }
+    }
+    return best;
+  }
+
+  const UsageRecord& record() const { return rec_; }
+
+  void load(const UsageRecord& r) {
+    rec_ = r;
+    dirty_ = false;
+  }
+
+  // Cambió desde la última vez que se grabó
+  bool dirty() const { return dirty_; }
+
+  void markSaved(uint16_t seq) {
+    rec_.seq = seq;
+    dirty_ = false;
+  }
+
+private:
+  UsageRecord rec_;
+  bool dirty_;
+};
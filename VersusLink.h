@@ -0,0 +1,387 @@
+#pragma once
+
+// Modo versus: dos gabinetes unidos por la UART juegan la misma secuencia.
+//
+// El tablero donde se arranca la partida (líder) manda la semilla y después
+// la largada de cada ronda; el otro (seguidor) adopta la semilla y espera
+// esa largada. Cada uno juega solo su ronda y espera a que el otro termine
+// la suya, así los dos ven el patrón al mismo tiempo. Los retardos viajan
+// relativos ("dentro de D ms") y el seguidor les descuenta la demora de la
+// línea, medida con PING/PONG.
+//
+// Si uno pierde o el cable queda mudo, el otro sigue solo. Si los dos
+// arrancan a la vez, se queda la partida de semilla más baja.
+//
+// Tramas: 0x7E, tipo, datos de largo fijo según el tipo, suma de control.
+// update() lee como mucho kRxBudget bytes y manda como mucho una trama por
+// pasada, y solo si entra entera en el buffer de salida: nunca espera.
+
+#include <Arduino.h>
+#include "Simon.h"
+
+class VersusLink {
+public:
+  static const uint8_t kRxBudget = 16;         // bytes leídos por pasada
+  static const uint16_t kStartDelayMs = 150;   // margen para que llegue la trama
+  static const uint16_t kPingMs = 500;
+  static const uint16_t kLinkTimeoutMs = 2000;
+  static const uint16_t kHoldMaxMs = 15000;    // espera máxima por el otro
+
+  VersusLink(HardwareSerial& port, GameController& game, DisplayLCD& display)
+    : port_(port), game_(game), display_(display),
+      role_(Role::NONE), seed_(0), joined_(false), startSent_(false),
+      waitLevel_(0), waitSince_(0),
+      remoteTag_(0), remoteLevel_(0), remoteFlags_(0),
+      heard_(false), lastHeardMs_(0), lastPingMs_(0),
+      oneWayMs_(0), rttValid_(false), compensate_(true),
+      pending_(0), pongT_(0), roundLevel_(0),
+      sentTag_(0), sentLevel_(0), sentFlags_(0), shownKey_(0),
+      rxPos_(0), rxType_(0), rxLen_(0), rxSum_(0),
+      framesIn_(0), framesOut_(0), badFrames_(0) {}
+
+  // Después de game.begin()
+  void begin() {
+    game_.setRoundGate(true);
+    role_ = Role::NONE;
+    pending_ = 0;
+    rxPos_ = 0;
+  }
+
+  void update() {
+    update(Clock::now());
+  }
+
+  // Con el instante de la pasada, el mismo que recibió game.loop()
+  void update(Instant now) {
+    unsigned long ms = now.ms();
+    for (uint8_t n = 0; n < kRxBudget && port_.available() > 0; ++n) {
+      feed((uint8_t)port_.read(), ms);
+    }
+    track(ms);
+    transmit(ms);
+  }
+
+  // Sin compensación el seguidor larga cuando le llega la trama
+  void setCompensation(bool on) { compensate_ = on; }
+
+  bool linked(unsigned long now) const {
+    return heard_ && now - lastHeardMs_ < kLinkTimeoutMs;
+  }
+
+  // La partida actual la juegan los dos tableros
+  bool joined() const { return joined_; }
+  bool leader() const { return role_ == Role::LEADER; }
+  uint16_t oneWayMs() const { return oneWayMs_; }
+  uint32_t framesIn() const { return framesIn_; }
+  uint32_t framesOut() const { return framesOut_; }
+  uint32_t badFrames() const { return badFrames_; }
+
+private:
+  enum class Role : uint8_t { NONE, LEADER, FOLLOWER };
+
+  static const uint8_t kSof = 0x7E;
+  static const uint8_t kPing = 'P';    // t(4)
+  static const uint8_t kPong = 'Q';    // t(4) devuelto
+  static const uint8_t kStart = 'S';   // semilla(4) retardo(2)
+  static const uint8_t kRound = 'R';   // tag(2) nivel(1) retardo(2)
+  static const uint8_t kProg = 'G';    // tag(2) nivel(1) flags(1)
+
+  // flags de progreso
+  static const uint8_t kPlaying = 1;
+  static const uint8_t kWaiting = 2;
+  static const uint8_t kOver = 4;
+  static const uint8_t kWon = 8;
+
+  // tramas pendientes, en orden de prioridad
+  static const uint8_t kTxStart = 1;
+  static const uint8_t kTxRound = 2;
+  static const uint8_t kTxPong = 4;
+  static const uint8_t kTxProg = 8;
+  static const uint8_t kTxPing = 16;
+
+  HardwareSerial& port_;
+  GameController& game_;
+  DisplayLCD& display_;
+
+  Role role_;
+  uint32_t seed_;           // semilla de la partida actual
+  bool joined_;
+  bool startSent_;
+  uint8_t waitLevel_;
+  unsigned long waitSince_;
+
+  uint16_t remoteTag_;
+  uint8_t remoteLevel_;
+  uint8_t remoteFlags_;
+  bool heard_;
+  unsigned long lastHeardMs_;
+  unsigned long lastPingMs_;
+  uint16_t oneWayMs_;
+  bool rttValid_;
+  bool compensate_;
+
+  uint8_t pending_;
+  uint32_t pongT_;
+  uint8_t roundLevel_;
+  uint16_t sentTag_;
+  uint8_t sentLevel_;
+  uint8_t sentFlags_;
+  uint32_t shownKey_;
+
+  uint8_t rxPos_;           // 0 = buscando 0x7E
+  uint8_t rxType_;
+  uint8_t rxLen_;
+  uint8_t rxSum_;
+  uint8_t rxBuf_[6];
+
+  uint32_t framesIn_;
+  uint32_t framesOut_;
+  uint32_t badFrames_;
+
+  uint16_t tag() const { return (uint16_t)seed_; }
+
+  static uint8_t payloadLen(uint8_t type) {
+    switch (type) {
+      case kPing:  return 4;
+      case kPong:  return 4;
+      case kStart: return 6;
+      case kRound: return 5;
+      case kProg:  return 4;
+    }
+    return 0;
+  }
+
+  static void put16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)(v >> 8);
+    p[1] = (uint8_t)v;
+  }
+
+  static void put32(uint8_t* p, uint32_t v) {
+    put16(p, (uint16_t)(v >> 16));
+    put16(p + 2, (uint16_t)v);
+  }
+
+  static uint16_t get16(const uint8_t* p) {
+    return (uint16_t)((p[0] << 8) | p[1]);
+  }
+
+  static uint32_t get32(const uint8_t* p) {
+    return ((uint32_t)get16(p) << 16) | get16(p + 2);
+  }
+
+  // Retardo recibido menos lo que ya tardó en llegar
+  uint16_t localDelay(uint16_t delayMs) const {
+    if (!compensate_) return delayMs;
+    return delayMs > oneWayMs_ ? (uint16_t)(delayMs - oneWayMs_) : 0;
+  }
+
+  void feed(uint8_t c, unsigned long now) {
+    if (rxPos_ == 0) {
+      if (c == kSof) rxPos_ = 1;
+      return;
+    }
+    if (rxPos_ == 1) {
+      rxLen_ = payloadLen(c);
+      if (rxLen_ == 0) {
+        ++badFrames_;
+        rxPos_ = c == kSof ? 1 : 0;
+        return;
+      }
+      rxType_ = c;
+      rxSum_ = c;
+      rxPos_ = 2;
+      return;
+    }
+    uint8_t idx = (uint8_t)(rxPos_ - 2);
+    if (idx < rxLen_) {
+      rxBuf_[idx] = c;
+      rxSum_ = (uint8_t)(rxSum_ + c);
+      ++rxPos_;
+      return;
+    }
+    rxPos_ = 0;
+    if ((uint8_t)~rxSum_ != c) {
+      ++badFrames_;
+      return;
+    }
+    handle(now);
+  }
+
+  void handle(unsigned long now) {
+    ++framesIn_;
+    heard_ = true;
+    lastHeardMs_ = now;
+    switch (rxType_) {
+      case kPing:
+        pongT_ = get32(rxBuf_);
+        pending_ |= kTxPong;
+        break;
+
+      case kPong: {
+        // la mitad del RTT; baja de golpe y sube despacio, porque un PONG
+        // tardío suele ser el otro loop() ocupado y no el cable
+        uint16_t half = (uint16_t)((now - get32(rxBuf_)) / 2);
+        if (!rttValid_ || half < oneWayMs_) oneWayMs_ = half;
+        else oneWayMs_ = (uint16_t)((7u * oneWayMs_ + half) / 8);
+        rttValid_ = true;
+        break;
+      }
+
+      case kStart:
+        onStart(get32(rxBuf_), get16(rxBuf_ + 4), now);
+        break;
+
+      case kRound:
+        if (role_ == Role::FOLLOWER && get16(rxBuf_) == tag() &&
+            game_.waitingRound() && game_.level() == rxBuf_[2]) {
+          game_.openRound(now + localDelay(get16(rxBuf_ + 3)));
+        }
+        break;
+
+      case kProg:
+        remoteTag_ = get16(rxBuf_);
+        remoteLevel_ = rxBuf_[2];
+        remoteFlags_ = rxBuf_[3];
+        if (role_ != Role::NONE && remoteTag_ == tag()) joined_ = true;
+        break;
+    }
+  }
+
+  void onStart(uint32_t seed, uint16_t delayMs, unsigned long now) {
+    if (game_.replaying()) return;
+    State s = game_.state();
+    bool idle = s == State::IDLE || s == State::GAME_OVER;
+    // arrancaron los dos a la vez: cede el de semilla más alta
+    bool clash = role_ == Role::LEADER && !joined_ && game_.level() == 1 &&
+                 s == State::SHOW_PATTERN && seed < seed_;
+    if (!idle && !clash) return;
+
+    game_.startGame(seed);
+    role_ = Role::FOLLOWER;
+    seed_ = seed;
+    joined_ = true;
+    startSent_ = true;
+    waitLevel_ = 0;
+    game_.openRound(now + localDelay(delayMs));
+  }
+
+  // Sigue la partida local: quién la empezó, cuándo largar cada ronda y
+  // qué progreso contarle al otro
+  void track(unsigned long now) {
+    State s = game_.state();
+    if (s == State::IDLE || s == State::SETTINGS || s == State::CALIBRATE ||
+        s == State::STATS) {
+      role_ = Role::NONE;
+    } else if (role_ == Role::NONE || game_.seed() != seed_) {
+      // la empezó un botón de este tablero
+      role_ = Role::LEADER;
+      seed_ = game_.seed();
+      joined_ = false;
+      startSent_ = false;
+      waitLevel_ = 0;
+    }
+
+    if (game_.waitingRound()) {
+      if (game_.level() != waitLevel_) {
+        waitLevel_ = game_.level();
+        waitSince_ = now;
+      }
+      bool link = linked(now);
+      bool timedOut = now - waitSince_ >= kHoldMaxMs;
+      bool alone = !joined_ || !link || remoteTag_ != tag() ||
+                   !(remoteFlags_ & kPlaying) || timedOut;
+
+      if (role_ == Role::LEADER && !startSent_) {
+        // si el otro todavía juega la anterior, se lo espera
+        bool busy = link && (remoteFlags_ & kPlaying) && remoteTag_ != tag();
+        if (!busy || timedOut) {
+          startSent_ = true;
+          uint16_t d = link ? kStartDelayMs : 0;
+          if (link) pending_ |= kTxStart;
+          game_.openRound(now + d);
+        }
+      } else if (alone) {
+        game_.openRound(now);
+      } else if (role_ == Role::LEADER && remoteLevel_ == game_.level() &&
+                 (remoteFlags_ & kWaiting)) {
+        roundLevel_ = game_.level();
+        pending_ |= kTxRound;
+        game_.openRound(now + kStartDelayMs);
+      }
+    }
+
+    uint8_t flags = 0;
+    if (s == State::SHOW_PATTERN || s == State::WAIT_INPUT) flags |= kPlaying;
+    if (game_.waitingRound()) flags |= kWaiting;
+    if (s == State::GAME_OVER) flags |= game_.won() ? (kOver | kWon) : kOver;
+    if (flags != sentFlags_ || game_.level() != sentLevel_ || tag() != sentTag_) {
+      sentFlags_ = flags;
+      sentLevel_ = game_.level();
+      sentTag_ = tag();
+      pending_ |= kTxProg;
+    }
+
+    if (now - lastPingMs_ >= kPingMs) {
+      lastPingMs_ = now;
+      // el progreso se repite por si se perdió alguna trama
+      pending_ |= kTxPing | kTxProg;
+    }
+
+    // marcador del rival; se redibuja si algo cambió o se borró la pantalla
+    if (joined_ && s != State::IDLE && remoteTag_ == tag()) {
+      bool out = (remoteFlags_ & kOver) != 0;
+      uint32_t key = 1 | ((uint32_t)game_.level() << 8) |
+                     ((uint32_t)s << 16) | ((uint32_t)remoteLevel_ << 20) |
+                     ((uint32_t)out << 28);
+      if (key != shownKey_) {
+        shownKey_ = key;
+        display_.showRival(remoteLevel_, out);
+      }
+    } else {
+      shownKey_ = 0;
+    }
+  }
+
+  void transmit(unsigned long now) {
+    if (!pending_) return;
+    uint8_t bit = (uint8_t)(pending_ & -pending_);
+    uint8_t f[9];
+    uint8_t* p = f + 2;
+    switch (bit) {
+      case kTxStart:
+        f[1] = kStart;
+        put32(p, seed_);
+        put16(p + 4, kStartDelayMs);
+        break;
+      case kTxRound:
+        f[1] = kRound;
+        put16(p, tag());
+        p[2] = roundLevel_;
+        put16(p + 3, kStartDelayMs);
+        break;
+      case kTxPong:
+        f[1] = kPong;
+        put32(p, pongT_);
+        break;
+      case kTxProg:
+        f[1] = kProg;
+        put16(p, sentTag_);
+        p[2] = sentLevel_;
+        p[3] = sentFlags_;
+        break;
+      default:
+        f[1] = kPing;
+        put32(p, now);
+        break;
+    }
+    uint8_t len = payloadLen(f[1]);
+    if (port_.availableForWrite() < len + 3) return;
+    f[0] = kSof;
+    uint8_t sum = f[1];
+    for (uint8_t i = 0; i < len; ++i) sum = (uint8_t)(sum + p[i]);
+    p[len] = (uint8_t)~sum;
+    for (uint8_t i = 0; i < len + 3; ++i) port_.write(f[i]);
+    pending_ &= (uint8_t)~bit;
+    ++framesOut_;
+  }
+};
@@ -0,0 +1,123 @@
+// Valida la dificultad adaptativa (Difficulty.h) con jugadores sintéticos
+// de distinta habilidad: cada uno juega una sesión con tiempos fijos y otra
+// con el controlador, y se compara el porcentaje de rondas completadas con
+// el objetivo.
+//
+//   simon_adapt [--games N] [--target PERMILLE] [--perception a,b,c]
+//               [--error PERMILLE] [--trace]
+//
+// La habilidad es PlayerConfig::perceptionMs: cuanto más alto, más se le
+// escapan los pasos cortos. Con --trace imprime la evolución ronda a ronda.
+
+#include "Sim.h"
+#include "Station.h"
+#include "Player.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+struct SessionResult {
+  uint32_t rounds = 0;
+  uint32_t ok = 0;
+  uint32_t lateRounds = 0;    // segunda mitad de la sesión
+  uint32_t lateOk = 0;
+  uint32_t games = 0;
+  uint32_t wins = 0;
+};
+
+static SessionResult playSession(uint16_t perceptionMs, uint16_t errorPermille,
+                                 uint32_t games, AdaptiveDifficulty* diff, bool trace) {
+  sim::Board board;
+  sim::use(&board);
+  sim::reset(perceptionMs * 31u + 7);
+  Station st;
+  st.begin();
+  st.game.setDifficulty(diff);
+
+  PlayerConfig pc;
+  pc.perceptionMs = perceptionMs;
+  pc.errorPermille = errorPermille;
+  pc.seed = perceptionMs + 1u;
+  SyntheticPlayer player(BUTTON_PINS, LED_PINS, 4, pc);
+  player.setGamesToPlay(games);
+
+  SessionResult res;
+  State last = st.game.state();
+  const uint64_t limitUs = 24ULL * 3600 * 1000000;
+  while (!(player.done() && st.game.state() == State::IDLE) && board.nowUs < limitUs) {
+    st.game.loop();
+    player.update();
+    State s = st.game.state();
+    if (s != last) {
+      bool ended = last == State::WAIT_INPUT &&
+                   (s == State::SHOW_PATTERN || s == State::GAME_OVER);
+      if (ended) {
+        bool ok = s == State::SHOW_PATTERN || st.game.won();
+        ++res.rounds;
+        res.ok += ok;
+        if (res.games >= games / 2) {
+          ++res.lateRounds;
+          res.lateOk += ok;
+        }
+        if (trace && diff) {
+          printf("  %5u %c nivel %2u  exito %4u‰  velocidad x%.2f  on %3u ms  "
+                 "reaccion %3u ms  error en %3u‰  ganar con %u\n",
+                 res.rounds, ok ? '+' : '-', st.game.level(), diff->successPermille(),
+                 diff->speedQ8() / 256.0, diff->timing().onMs, diff->reactionMs(),
+                 diff->errorPosPermille(), diff->winScore());
+        }
+      }
+      if (s == State::GAME_OVER) {
+        ++res.games;
+        res.wins += st.game.won();
+      }
+      last = s;
+    }
+    sim::advance(200);
+  }
+  sim::use(nullptr);
+  return res;
+}
+
+int main(int argc, char** argv) {
+  uint32_t games = 150;
+  uint16_t target = 700;
+  uint16_t errorPermille = 5;
+  bool trace = false;
+  std::vector<uint16_t> perception = {120, 250, 400, 600};
+  for (int i = 1; i < argc; ++i) {
+    if (!strcmp(argv[i], "--trace")) trace = true;
+    else if (i + 1 < argc && !strcmp(argv[i], "--games")) games = (uint32_t)strtoul(argv[++i], nullptr, 10);
+    else if (i + 1 < argc && !strcmp(argv[i], "--target")) target = (uint16_t)atoi(argv[++i]);
+    else if (i + 1 < argc && !strcmp(argv[i], "--error")) errorPermille = (uint16_t)atoi(argv[++i]);
+    else if (i + 1 < argc && !strcmp(argv[i], "--perception")) {
+      perception.clear();
+      for (const char* p = argv[++i]; *p;) {
+        char* end;
+        perception.push_back((uint16_t)strtoul(p, &end, 10));
+        p = *end == ',' ? end + 1 : end;
+        if (end == p && *p) break;
+      }
+    } else {
+      fprintf(stderr, "opción desconocida: %s\n", argv[i]);
+      return 2;
+    }
+  }
+
+  printf("objetivo: %u‰ de rondas completadas, %u partidas por sesión\n\n", target, games);
+  printf("%-12s %16s %16s %10s %10s %8s\n", "percepción", "fijo (‰)", "adaptativo (‰)",
+         "velocidad", "on (ms)", "ganar");
+  for (uint16_t p : perception) {
+    SessionResult fixed = playSession(p, errorPermille, games, nullptr, false);
+    AdaptiveDifficulty diff(DEFAULT_TIMING, target);
+    if (trace) printf("percepción %u ms:\n", p);
+    SessionResult adapt = playSession(p, errorPermille, games, &diff, trace);
+    printf("%-10u ms %16u %16u %9.2fx %10u %8u\n", p,
+           fixed.lateRounds ? fixed.lateOk * 1000 / fixed.lateRounds : 0,
+           adapt.lateRounds ? adapt.lateOk * 1000 / adapt.lateRounds : 0,
+           diff.speedQ8() / 256.0, diff.timing().onMs, diff.winScore());
+  }
+  printf("\n(‰ de rondas completadas en la segunda mitad de cada sesión)\n");
+  return 0;
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+// Arduino.h para el simulador en la PC.
+// Misma API que el core de AVR que usa el sketch, pero los pines, el reloj
+// y el generador aleatorio viven en sim::Board (ver Sim.h). El tiempo es
+// virtual: solo avanza con sim::advance() y delay().
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT        0x0
+#define OUTPUT       0x1
+#define INPUT_PULLUP 0x2
+
+#define DEC 10
+#define HEX 16
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+// Pines analógicos del Uno
+static const uint8_t A0 = 14;
+static const uint8_t A1 = 15;
+static const uint8_t A2 = 16;
+static const uint8_t A3 = 17;
+static const uint8_t A4 = 18;
+static const uint8_t A5 = 19;
+
+// En el AVR las tablas constantes van a flash y se leen con pgm_read_*
+// (avr/pgmspace.h, que ya incluye el Arduino.h de verdad). En la PC son
+// memoria común.
+#define PROGMEM
+#define PSTR(s) (s)
+#define pgm_read_byte(p) (*(const uint8_t*)(p))
+#define pgm_read_word(p) (*(const uint16_t*)(p))
+#define strcmp_P strcmp
+
+// F("texto"): en el AVR queda en flash y print() lo lee de ahí
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper*>(PSTR(s)))
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+// Las "interrupciones" del simulador solo corren dentro de sim::advance(),
+// así que no hace falta apagarlas
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+void tone(uint8_t pin, unsigned int frequency, unsigned long duration = 0);
+void noTone(uint8_t pin);
+
+// Mismo algoritmo que random() de avr-libc, así una semilla del Arduino
+// produce el mismo patrón en la PC
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+
+// Print mínimo: lo que usan LiquidCrystal y Serial
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+
+  size_t write(const char* s) {
+    size_t n = 0;
+    while (*s) n += write((uint8_t)*s++);
+    return n;
+  }
+
+  size_t print(const char* s) { return write(s); }
+  size_t print(const __FlashStringHelper* s) { return write((const char*)s); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(unsigned char v, int base = DEC) { return printNumber(v, base); }
+  size_t print(int v, int base = DEC) { return print((long)v, base); }
+  size_t print(unsigned int v, int base = DEC) { return printNumber(v, base); }
+  size_t print(unsigned long v, int base = DEC) { return printNumber(v, base); }
+
+  size_t print(long v, int base = DEC) {
+    if (v < 0 && base == DEC) {
+      return write((uint8_t)'-') + printNumber((unsigned long)(-v), base);
+    }
+    return printNumber((unsigned long)v, base);
+  }
+
+  size_t println() { return write((uint8_t)'\r') + write((uint8_t)'\n'); }
+
+  template <typename T>
+  size_t println(T v) { return print(v) + println(); }
+
+private:
+  size_t printNumber(unsigned long v, int base) {
+    char buf[8 * sizeof(long) + 1];
+    char* p = &buf[sizeof(buf) - 1];
+    *p = '\0';
+    do {
+      unsigned long d = v % base;
+      *--p = (char)(d < 10 ? '0' + d : 'A' + d - 10);
+      v /= base;
+    } while (v);
+    return write(p);
+  }
+};
+
+// Serial del simulador: lo recibido se carga con sim::serialInput() y lo
+// enviado va a sim::Board::serialTx
+class HardwareSerial : public Print {
+public:
+  void begin(unsigned long baud);
+  void end() {}
+  int available();
+  int peek();
+  int read();
+  int availableForWrite() { return 63; }
+  void flush() {}
+  size_t write(uint8_t c) override;
+  using Print::write;
+  operator bool() const { return true; }
+};
+
+extern HardwareSerial Serial;
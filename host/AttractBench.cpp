@@ -0,0 +1,98 @@
+// Mide el modo de atracción (Attract.h) en el simulador: uso de CPU dentro
+// de las tareas del Scheduler, transferencias al LCD, cuánto se podría
+// dormir entre cuadros y cuánto tarda en cortarse al tocar un botón.
+//
+//   simon_attract [--seconds S] [--presses N]
+//
+// El tiempo de las tareas sale del reloj virtual: lo que cuesta de verdad
+// en la placa es sobre todo el bus del LCD (sim::kLcdByteUs por byte).
+
+#include "Sim.h"
+#include "Station.h"
+#include "LiquidCrystal.h"
+#include "../Scheduler.h"
+#include "../Attract.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+struct Rig {
+  Station st;
+  Scheduler sched;
+  AttractMode attract;
+  uint64_t sleepUs = 0;     // tiempo en que no había ninguna tarea por vencer
+
+  Rig() : attract(sched, st.game, st.leds, st.buzzer, st.display) {}
+
+  void begin() {
+    st.begin();
+    attract.begin();
+  }
+
+  // La pasada de loop() de main.cpp
+  void pass(unsigned long passUs) {
+    if (attractLoopPass(st.game, attract, sched, Clock::now())) sleepUs += passUs;
+    sim::advance(passUs);
+  }
+};
+
+int main(int argc, char** argv) {
+  unsigned seconds = 60;
+  unsigned presses = 200;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    if (!strcmp(argv[i], "--seconds")) seconds = (unsigned)atoi(argv[i + 1]);
+    else if (!strcmp(argv[i], "--presses")) presses = (unsigned)atoi(argv[i + 1]);
+    else {
+      fprintf(stderr, "opción desconocida: %s\n", argv[i]);
+      return 2;
+    }
+  }
+  const unsigned long passUs = 200;
+
+  // 1) una tirada larga en atracción
+  sim::reset(1);
+  Rig rig;
+  rig.begin();
+  while (!rig.attract.active()) rig.pass(passUs);
+  uint64_t t0 = sim::board().nowUs;
+  uint32_t lcd0 = rig.st.lcd.busTransfers();
+  uint32_t frames0 = rig.attract.frames();
+  rig.sched.resetStats();
+  rig.sleepUs = 0;
+  while (sim::board().nowUs - t0 < (uint64_t)seconds * 1000000) rig.pass(passUs);
+  double secs = (sim::board().nowUs - t0) / 1e6;
+  printf("atracción durante %.0f s: %u cuadros, CPU en tareas %.2f %% (%u‰ según el Scheduler)\n",
+         secs, rig.attract.frames() - frames0, rig.sched.busyUs() / 1e4 / secs,
+         rig.sched.dutyPermille());
+  printf("  LCD: %.1f transferencias/s  tiempo sin tareas por vencer: %.1f %%\n",
+         (rig.st.lcd.busTransfers() - lcd0) / secs, rig.sleepUs / 1e4 / secs);
+
+  // 2) cortar con un botón en momentos al azar
+  uint64_t worstUs = 0;
+  unsigned worstPasses = 0, aborted = 0;
+  srand(7);
+  for (unsigned k = 0; k < presses; ++k) {
+    sim::reset(k + 2);
+    Rig r;
+    r.begin();
+    while (!r.attract.active()) r.pass(passUs);
+    unsigned wait = (unsigned)(rand() % 20000) * 1000 / passUs;
+    for (unsigned i = 0; i < wait; ++i) r.pass(passUs);
+
+    uint8_t btn = (uint8_t)(rand() % 4);
+    sim::setInput(BUTTON_PINS[btn], LOW);
+    uint64_t pressUs = sim::board().nowUs;
+    unsigned passes = 0;
+    while (r.attract.active() && passes < 100000) {
+      r.pass(passUs);
+      ++passes;
+    }
+    if (!r.attract.active()) ++aborted;
+    uint64_t took = sim::board().nowUs - pressUs;
+    if (took > worstUs) worstUs = took;
+    if (passes > worstPasses) worstPasses = passes;
+  }
+  printf("corte por botón: %u/%u, peor caso %u pasada(s) de loop() (%.1f ms)\n",
+         aborted, presses, worstPasses, worstUs / 1000.0);
+  return 0;
+}
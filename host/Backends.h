@@ -0,0 +1,99 @@
+#pragma once
+
+// Periféricos alternativos para las herramientas del simulador (ver
+// ArduinoPeripherals en Simon.h): los que cuentan llamadas siguen haciendo
+// lo mismo que los de la placa; NullDisplay no escribe nada.
+
+#include "../Simon.h"
+
+struct BackendCounts {
+  uint64_t leds = 0;
+  uint64_t sounds = 0;
+};
+
+inline BackendCounts backendCounts;
+
+class CountingLeds : public LEDDriver {
+public:
+  CountingLeds(const uint8_t* pins, uint8_t count) : LEDDriver(pins, count) {}
+
+  void on(uint8_t idx) {
+    ++backendCounts.leds;
+    LEDDriver::on(idx);
+  }
+
+  void off(uint8_t idx) {
+    ++backendCounts.leds;
+    LEDDriver::off(idx);
+  }
+
+  void offAll() {
+    ++backendCounts.leds;
+    LEDDriver::offAll();
+  }
+
+  uint8_t apply(uint8_t mask, uint8_t levels) {
+    ++backendCounts.leds;
+    return LEDDriver::apply(mask, levels);
+  }
+};
+
+class CountingBuzzer : public Buzzer {
+public:
+  explicit CountingBuzzer(uint8_t pin) : Buzzer(pin) {}
+
+  void beep(uint16_t ms, unsigned int freq) {
+    ++backendCounts.sounds;
+    Buzzer::beep(ms, freq);
+  }
+
+  void click(uint8_t idx) {
+    ++backendCounts.sounds;
+    Buzzer::click(idx);
+  }
+
+  void success() {
+    ++backendCounts.sounds;
+    Buzzer::success();
+  }
+
+  void fail() {
+    ++backendCounts.sounds;
+    Buzzer::fail();
+  }
+};
+
+// Los mismos métodos que DisplayLCD, vacíos
+class NullDisplay {
+public:
+  explicit NullDisplay(LiquidCrystal&) {}
+  void begin() {}
+  void showPressToStart() {}
+  void showLevel(uint8_t, int) {}
+  void showGameOver(int, int) {}
+  void showWin(int, int) {}
+  void showSetting(const char*, int, const char* = nullptr) {}
+  void showButtonValues(const char*, const uint8_t*, uint8_t) {}
+  void showButtonValue(uint8_t, uint8_t) {}
+  void showUsage(uint8_t, const UsageStats&) {}
+  void showPlayers(const PlayerArena&) {}
+  void showPlayerScore(uint8_t, const PlayerSlot&) {}
+  void showTurn(uint8_t, uint8_t) {}
+  void showPlayerTag(uint8_t) {}
+};
+
+struct CountingPeripherals : ArduinoPeripherals {
+  typedef CountingLeds   Leds;
+  typedef CountingBuzzer Sound;
+};
+
+struct HeadlessPeripherals : ArduinoPeripherals {
+  typedef NullDisplay Display;
+};
+
+// Estado compacto (SIMON_PACKED) sin recompilar: tiempos de 16 bits en los
+// botones y cuatro pasos por byte en el patrón
+struct CompactPeripherals : ArduinoPeripherals {
+  typedef BasicPatternManager<true> Pattern;
+  typedef BasicButtonReader<true>   Buttons;
+};
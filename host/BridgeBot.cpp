@@ -0,0 +1,107 @@
+// Bot de ejemplo para simon_bridge: se conecta al socket, mira el LCD y los
+// LEDs y repite el patrón. Sirve de referencia del protocolo.
+//
+//   simon_bridge_bot [--socket /tmp/simon.sock] [--games N]
+
+#include "BridgeProtocol.h"
+#include "../Pins.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+static int fd = -1;
+
+static void sendPress(uint8_t button, uint16_t holdMs) {
+  uint8_t m[4] = {bridge::PRESS, button};
+  bridge::put16(m + 2, holdMs);
+  if (write(fd, m, sizeof(m)) != (ssize_t)sizeof(m)) perror("write");
+}
+
+static int ledIndex(uint8_t pin) {
+  for (uint8_t i = 0; i < 4; ++i) {
+    if (LED_PINS[i] == pin) return i;
+  }
+  return -1;
+}
+
+int main(int argc, char** argv) {
+  const char* path = "/tmp/simon.sock";
+  unsigned games = 5;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    if (!strcmp(argv[i], "--socket")) path = argv[i + 1];
+    else if (!strcmp(argv[i], "--games")) games = (unsigned)atoi(argv[i + 1]);
+  }
+
+  fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  sockaddr_un addr = {};
+  addr.sun_family = AF_UNIX;
+  strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+  if (fd < 0 || connect(fd, (sockaddr*)&addr, sizeof(addr)) != 0) {
+    perror("simon_bridge_bot");
+    return 1;
+  }
+
+  std::vector<uint8_t> in;
+  std::vector<uint8_t> seq;
+  unsigned started = 0, played = 0, wins = 0;
+  unsigned level = 0;
+  bool watching = false;
+  unsigned long messages = 0;
+
+  while (played < games) {
+    uint8_t buf[4096];
+    ssize_t n = read(fd, buf, sizeof(buf));
+    if (n <= 0) break;
+    in.insert(in.end(), buf, buf + n);
+
+    size_t pos = 0;
+    while (pos < in.size()) {
+      uint8_t len = bridge::messageSize(in[pos]);
+      if (len == 0) {
+        fprintf(stderr, "mensaje desconocido 0x%02X\n", in[pos]);
+        return 1;
+      }
+      if (pos + len > in.size()) break;
+      const uint8_t* m = &in[pos];
+      pos += len;
+      ++messages;
+
+      if (m[0] == bridge::LCD && m[5] == 0) {
+        const char* text = (const char*)m + 6;
+        if (!strncmp(text, "Presiona", 8) && started < games) {
+          ++started;
+          sendPress(0, 80);
+        } else if (!strncmp(text, "Nivel: ", 7)) {
+          level = (unsigned)atoi(std::string(text + 7, bridge::kLcdCols - 7).c_str());
+          seq.clear();
+          watching = true;
+        } else if (!strncmp(text, "Game Over", 9) || !strncmp(text, "!GANASTE!", 9)) {
+          ++played;
+          if (text[0] == '!') ++wins;
+          watching = false;
+          sendPress(0, 80);   // volver a IDLE
+        }
+      } else if (m[0] == bridge::PIN && watching) {
+        int led = ledIndex(m[5]);
+        if (led < 0) continue;
+        if (m[6] == 1) {
+          seq.push_back((uint8_t)led);
+        } else if (seq.size() >= level) {
+          // se apagó el último paso: repetir todo
+          for (uint8_t b : seq) sendPress(b, 80);
+          watching = false;
+        }
+      }
+    }
+    in.erase(in.begin(), in.begin() + pos);
+  }
+
+  printf("partidas: %u  ganadas: %u  mensajes recibidos: %lu\n", played, wins, messages);
+  close(fd);
+  return played == games ? 0 : 1;
+}
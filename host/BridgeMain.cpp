@@ -0,0 +1,288 @@
+// Puente por socket Unix para que bots y herramientas externas jueguen en
+// el simulador (protocolo en BridgeProtocol.h). Hace de cable serie local.
+//
+//   simon_bridge [--socket /tmp/simon.sock] [--speed 1] [--seed S] [--once]
+//
+// --speed 1 corre a tiempo real, N más rápido y 0 tan rápido como se pueda.
+// El socket se atiende con poll() desde el mismo lazo que corre loop():
+// como mucho una vez por milisegundo virtual, o cuando el reloj virtual
+// está adelantado al real y de todos modos hay que esperar. Los mensajes
+// acumulados entre dos atenciones salen juntos en un solo write().
+// Con --once termina cuando se desconecta el último cliente.
+
+#include "Sim.h"
+#include "LiquidCrystal.h"
+#include "BridgeProtocol.h"
+#include "../Pins.h"
+
+#include <chrono>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <vector>
+
+void setup();
+void loop();
+
+struct Client {
+  int fd;
+  std::vector<uint8_t> in;
+  std::vector<uint8_t> out;
+};
+
+struct Press {
+  uint8_t button;
+  uint16_t holdMs;
+};
+
+// Los clientes lentos no frenan el reloj: si acumulan esto, se cortan
+static const size_t kMaxBacklog = 1 << 20;
+
+static std::vector<Client> clients;
+static std::vector<Press> presses;
+static size_t pressPos = 0;
+static bool pressing = false;
+static unsigned long pressNextMs = 0;
+
+static uint64_t msgsOut = 0, msgsIn = 0, bytesOut = 0;
+static volatile sig_atomic_t stopRequested = 0;
+
+static void onSignal(int) { stopRequested = 1; }
+
+static void broadcast(const uint8_t* msg, uint8_t len) {
+  for (Client& c : clients) c.out.insert(c.out.end(), msg, msg + len);
+  msgsOut += clients.size();
+}
+
+static void onPin(uint8_t pin, uint8_t level, void*) {
+  uint8_t m[7] = {bridge::PIN};
+  bridge::put32(m + 1, millis());
+  m[5] = pin;
+  m[6] = level;
+  broadcast(m, sizeof(m));
+}
+
+static void onTone(unsigned int freq, uint64_t, void*) {
+  uint8_t m[7] = {bridge::TONE};
+  bridge::put32(m + 1, millis());
+  bridge::put16(m + 5, (uint16_t)freq);
+  broadcast(m, sizeof(m));
+}
+
+static void sendHello(Client& c) {
+  uint8_t m[4] = {bridge::HELLO, bridge::kVersion, 4, 4};
+  c.out.insert(c.out.end(), m, m + sizeof(m));
+  ++msgsOut;
+}
+
+static void sendLcdRow(Client* only, uint8_t row, const char* text) {
+  uint8_t m[6 + bridge::kLcdCols] = {bridge::LCD};
+  bridge::put32(m + 1, millis());
+  m[5] = row;
+  memcpy(m + 6, text, bridge::kLcdCols);
+  if (only) {
+    only->out.insert(only->out.end(), m, m + sizeof(m));
+    ++msgsOut;
+  } else {
+    broadcast(m, sizeof(m));
+  }
+}
+
+static void handleMessage(const uint8_t* m) {
+  ++msgsIn;
+  if (m[0] == bridge::PRESS && m[1] < 4) {
+    presses.push_back(Press{m[1], bridge::get16(m + 2)});
+  } else if (m[0] == bridge::LEVEL && m[1] < 4) {
+    sim::setInput(BUTTON_PINS[m[1]], m[2] ? HIGH : LOW);
+  }
+}
+
+// Toques encolados por los clientes, en tiempo virtual
+static void runPresses() {
+  unsigned long now = millis();
+  if (pressPos >= presses.size() || (long)(now - pressNextMs) < 0) return;
+  const Press& p = presses[pressPos];
+  sim::setInput(BUTTON_PINS[p.button], pressing ? HIGH : LOW);
+  pressNextMs = now + p.holdMs;
+  if (pressing && ++pressPos == presses.size()) {
+    presses.clear();
+    pressPos = 0;
+  }
+  pressing = !pressing;
+}
+
+static void service(int listenFd, int timeoutMs) {
+  std::vector<pollfd> fds;
+  fds.push_back(pollfd{listenFd, POLLIN, 0});
+  for (Client& c : clients) {
+    short ev = POLLIN;
+    if (!c.out.empty()) ev |= POLLOUT;
+    fds.push_back(pollfd{c.fd, ev, 0});
+  }
+  if (poll(fds.data(), fds.size(), timeoutMs) <= 0) return;
+
+  std::vector<bool> dead(clients.size(), false);
+  for (size_t i = 0; i < clients.size(); ++i) {
+    Client& c = clients[i];
+    short rev = fds[i + 1].revents;
+    if (rev & (POLLERR | POLLHUP)) dead[i] = true;
+    if (rev & POLLIN) {
+      uint8_t buf[4096];
+      ssize_t n = read(c.fd, buf, sizeof(buf));
+      if (n <= 0) {
+        dead[i] = true;
+      } else {
+        c.in.insert(c.in.end(), buf, buf + n);
+        size_t pos = 0;
+        while (pos < c.in.size()) {
+          uint8_t len = bridge::messageSize(c.in[pos]);
+          if (len == 0) { dead[i] = true; break; }
+          if (pos + len > c.in.size()) break;
+          handleMessage(&c.in[pos]);
+          pos += len;
+        }
+        c.in.erase(c.in.begin(), c.in.begin() + pos);
+      }
+    }
+    if ((rev & POLLOUT) && !c.out.empty()) {
+      ssize_t n = write(c.fd, c.out.data(), c.out.size());
+      if (n > 0) {
+        bytesOut += (uint64_t)n;
+        c.out.erase(c.out.begin(), c.out.begin() + n);
+      } else if (n < 0 && errno != EAGAIN) {
+        dead[i] = true;
+      }
+    }
+    if (c.out.size() > kMaxBacklog) dead[i] = true;
+  }
+  for (size_t i = clients.size(); i-- > 0;) {
+    if (dead[i]) {
+      close(clients[i].fd);
+      clients.erase(clients.begin() + i);
+    }
+  }
+
+  if (fds[0].revents & POLLIN) {
+    int fd = accept(listenFd, nullptr, nullptr);
+    if (fd >= 0) {
+      fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+      clients.push_back(Client{fd, {}, {}});
+      Client& c = clients.back();
+      sendHello(c);
+      // estado actual para que el cliente no arranque a ciegas
+      const LiquidCrystal* lcd = sim::board().lcd;
+      char row[LiquidCrystal::kLineLen + 1];
+      for (uint8_t r = 0; lcd && r < 2; ++r) {
+        lcd->visibleRow(r, row);
+        sendLcdRow(&c, r, row);
+      }
+    }
+  }
+}
+
+int main(int argc, char** argv) {
+  const char* path = "/tmp/simon.sock";
+  double speed = 1.0;
+  uint32_t seed = (uint32_t)time(nullptr);
+  bool once = false;
+  for (int i = 1; i < argc; ++i) {
+    if (!strcmp(argv[i], "--once")) once = true;
+    else if (i + 1 < argc && !strcmp(argv[i], "--socket")) path = argv[++i];
+    else if (i + 1 < argc && !strcmp(argv[i], "--speed")) speed = atof(argv[++i]);
+    else if (i + 1 < argc && !strcmp(argv[i], "--seed")) seed = (uint32_t)strtoul(argv[++i], nullptr, 10);
+    else {
+      fprintf(stderr, "opción desconocida: %s\n", argv[i]);
+      return 2;
+    }
+  }
+
+  int listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+  sockaddr_un addr = {};
+  addr.sun_family = AF_UNIX;
+  strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+  unlink(path);
+  if (listenFd < 0 || bind(listenFd, (sockaddr*)&addr, sizeof(addr)) != 0 ||
+      listen(listenFd, 8) != 0) {
+    perror("simon_bridge");
+    return 1;
+  }
+  fcntl(listenFd, F_SETFL, fcntl(listenFd, F_GETFL) | O_NONBLOCK);
+  signal(SIGINT, onSignal);
+  signal(SIGTERM, onSignal);
+  signal(SIGPIPE, SIG_IGN);
+  fprintf(stderr, "simon_bridge escuchando en %s\n", path);
+
+  sim::reset(seed);
+  sim::board().onPin = onPin;
+  sim::board().onTone = onTone;
+  setup();
+
+  using Clock = std::chrono::steady_clock;
+  const Clock::time_point t0 = Clock::now();
+  Clock::time_point lastReport = t0;
+  uint64_t reportOut = 0, reportIn = 0;
+  const unsigned long passUs = 200;
+  const uint64_t serviceUs = 1000;
+  uint64_t lastServiceUs = 0;
+  char lcdShown[2][LiquidCrystal::kLineLen + 1] = {{0}, {0}};
+  bool hadClient = false;
+
+  while (!stopRequested) {
+    runPresses();
+    loop();
+    sim::advance(passUs);
+
+    const LiquidCrystal* lcd = sim::board().lcd;
+    char row[LiquidCrystal::kLineLen + 1];
+    for (uint8_t r = 0; lcd && r < 2; ++r) {
+      lcd->visibleRow(r, row);
+      if (strcmp(row, lcdShown[r]) != 0) {
+        strcpy(lcdShown[r], row);
+        sendLcdRow(nullptr, r, row);
+      }
+    }
+
+    uint64_t now = sim::board().nowUs;
+    int waitMs = 0;
+    if (speed > 0) {
+      double realUs = std::chrono::duration<double, std::micro>(Clock::now() - t0).count();
+      double aheadUs = now - realUs * speed;
+      if (aheadUs > 1000) waitMs = (int)(aheadUs / 1000 / speed);
+      if (waitMs > 10) waitMs = 10;
+    }
+    if (waitMs > 0 || now - lastServiceUs >= serviceUs) {
+      lastServiceUs = now;
+      service(listenFd, waitMs);
+      if (!clients.empty()) hadClient = true;
+      if (once && hadClient && clients.empty()) break;
+    }
+
+    Clock::time_point wall = Clock::now();
+    double secs = std::chrono::duration<double>(wall - lastReport).count();
+    if (secs >= 5.0) {
+      fprintf(stderr, "%zu clientes  salida %.0f msj/s  entrada %.0f msj/s  reloj x%.1f\n",
+              clients.size(), (msgsOut - reportOut) / secs, (msgsIn - reportIn) / secs,
+              now / 1e6 / std::chrono::duration<double>(wall - t0).count());
+      reportOut = msgsOut;
+      reportIn = msgsIn;
+      lastReport = wall;
+    }
+  }
+
+  double total = std::chrono::duration<double>(Clock::now() - t0).count();
+  fprintf(stderr, "total: %llu msj enviados (%.0f/s, %llu bytes), %llu recibidos (%.0f/s), "
+                  "%.1f s virtuales en %.1f s\n",
+          (unsigned long long)msgsOut, msgsOut / total, (unsigned long long)bytesOut,
+          (unsigned long long)msgsIn, msgsIn / total,
+          sim::board().nowUs / 1e6, total);
+  for (Client& c : clients) close(c.fd);
+  close(listenFd);
+  unlink(path);
+  return 0;
+}
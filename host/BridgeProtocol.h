@@ -0,0 +1,68 @@
+#pragma once
+
+// Protocolo binario del puente por socket Unix (simon_bridge).
+// Cada mensaje es un byte de tipo seguido de un cuerpo de largo fijo, en
+// little endian. Los mensajes de una misma pasada viajan juntos en un solo
+// write(), así que un lector debe procesar todos los que haya en el búfer.
+//
+// Simulador -> cliente
+//   HELLO  versión(1) botones(1) leds(1)
+//   PIN    t_ms(4) pin(1) nivel(1)       cambio de un pin de salida
+//   TONE   t_ms(4) frecuencia(2)         0 = silencio
+//   LCD    t_ms(4) fila(1) texto(16)     la fila visible cambió
+//
+// Cliente -> simulador
+//   PRESS  botón(1) hold_ms(2)   se encola; cada toque espera hold_ms antes
+//                                del siguiente
+//   LEVEL  botón(1) nivel(1)     control directo del pin (LOW = presionado)
+
+#include <stdint.h>
+#include <string.h>
+
+namespace bridge {
+
+const uint8_t kVersion = 1;
+
+enum MsgType : uint8_t {
+  HELLO = 0x00,
+  PIN   = 0x01,
+  TONE  = 0x02,
+  LCD   = 0x03,
+  PRESS = 0x10,
+  LEVEL = 0x11
+};
+
+const uint8_t kLcdCols = 16;
+
+// Largo total (tipo incluido); 0 = tipo desconocido
+inline uint8_t messageSize(uint8_t type) {
+  switch (type) {
+    case HELLO: return 4;
+    case PIN:   return 7;
+    case TONE:  return 7;
+    case LCD:   return 6 + kLcdCols;
+    case PRESS: return 4;
+    case LEVEL: return 3;
+  }
+  return 0;
+}
+
+inline void put16(uint8_t* p, uint16_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+}
+
+inline void put32(uint8_t* p, uint32_t v) {
+  for (uint8_t i = 0; i < 4; ++i) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+inline uint16_t get16(const uint8_t* p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+inline uint32_t get32(const uint8_t* p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+         ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+}  // namespace bridge
@@ -0,0 +1,184 @@
+// Calibración del antirrebote (Calibration.h) con botones que rebotan
+// distinto: primero calibra tocando cada botón, después compara la ventana
+// fija de siempre, una fija corta y la calibrada con toques rápidos.
+//
+//   simon_calibrate [--bounce 1,1,3,15] [--taps N] [--seed S]
+//
+// --bounce es cuántos ms rebota cada botón al cambiar. Por cada ventana
+// cuenta toques perdidos (el antirrebote todavía no lo dejaba ver), toques
+// de más (un rebote que pasó como otro toque) y la demora entre que se
+// aprieta el botón y el flanco: si se vuelve a apretar antes de que venza
+// la ventana del soltado, el flanco espera a que venza.
+
+#include "Sim.h"
+#include "../Pins.h"
+#include "../Simon.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static const unsigned long kPassUs = 200;
+
+// Cuatro contactos que rebotan al azar bounceMs[i] después de cada cambio
+struct Switches {
+  uint8_t bounceMs[4];
+  uint8_t level[4];           // nivel en que se asienta
+  uint64_t bounceUntilUs[4];
+  uint32_t rng;
+
+  explicit Switches(uint32_t seed) : rng(seed ? seed : 1) {
+    for (uint8_t i = 0; i < 4; ++i) {
+      bounceMs[i] = 0;
+      level[i] = HIGH;
+      bounceUntilUs[i] = 0;
+    }
+  }
+
+  uint32_t next() {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+  }
+
+  void set(uint8_t i, uint8_t lv) {
+    level[i] = lv;
+    bounceUntilUs[i] = sim::board().nowUs + bounceMs[i] * 1000ULL;
+    sim::setInput(BUTTON_PINS[i], lv);
+  }
+
+  void update() {
+    for (uint8_t i = 0; i < 4; ++i) {
+      uint8_t lv = level[i];
+      if (sim::board().nowUs < bounceUntilUs[i]) lv = (next() & 1) ? HIGH : LOW;
+      sim::setInput(BUTTON_PINS[i], lv);
+    }
+  }
+};
+
+static void wait(Switches& sw, unsigned long ms, BounceCalibrator* cal,
+                 ButtonReader* reader) {
+  for (unsigned long n = 0; n < ms * 1000 / kPassUs; ++n) {
+    sw.update();
+    if (cal) cal->sample(reader->readPins(), micros());
+    sim::advance(kPassUs);
+  }
+}
+
+struct TapStats {
+  uint32_t taps = 0, missed = 0, extra = 0;
+  uint64_t latencyUs = 0, maxLatencyUs = 0;
+};
+
+// Toques rápidos al azar con ventanas dadas
+static TapStats tapRun(const uint8_t bounce[4], const uint8_t windows[4],
+                       uint32_t taps, uint32_t seed) {
+  sim::reset(1);
+  Switches sw(seed);
+  for (uint8_t i = 0; i < 4; ++i) sw.bounceMs[i] = bounce[i];
+  ButtonReader reader(BUTTON_PINS, 4);
+  reader.begin();
+  for (uint8_t i = 0; i < 4; ++i) reader.setDebounce(i, windows[i]);
+
+  TapStats st;
+  for (uint32_t k = 0; k < taps; ++k) {
+    uint8_t b = (uint8_t)(sw.next() % 4);
+    unsigned long holdMs = 40 + sw.next() % 60;
+    unsigned long gapMs = 15 + sw.next() % 100;
+    uint64_t pressUs = sim::board().nowUs;
+    uint32_t edges = 0;
+    uint64_t firstUs = 0;
+    sw.set(b, LOW);
+    unsigned long passes = (holdMs + gapMs) * 1000 / kPassUs;
+    for (unsigned long n = 0; n < passes; ++n) {
+      if (n == holdMs * 1000 / kPassUs) sw.set(b, HIGH);
+      sw.update();
+      reader.update();
+      for (uint8_t i = 0; i < 4; ++i) {
+        if (!reader.risingEdge(i)) continue;
+        if (i == b && edges++ == 0) firstUs = sim::board().nowUs;
+        else ++st.extra;
+      }
+      sim::advance(kPassUs);
+    }
+    ++st.taps;
+    if (edges == 0) {
+      ++st.missed;
+      continue;
+    }
+    uint64_t lat = firstUs - pressUs;
+    st.latencyUs += lat;
+    if (lat > st.maxLatencyUs) st.maxLatencyUs = lat;
+  }
+  return st;
+}
+
+int main(int argc, char** argv) {
+  uint8_t bounce[4] = {1, 1, 3, 15};
+  uint32_t taps = 20000;
+  uint32_t seed = 1;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    if (!strcmp(argv[i], "--bounce")) {
+      unsigned v[4];
+      if (sscanf(argv[i + 1], "%u,%u,%u,%u", &v[0], &v[1], &v[2], &v[3]) != 4) {
+        fprintf(stderr, "--bounce a,b,c,d\n");
+        return 2;
+      }
+      for (int j = 0; j < 4; ++j) bounce[j] = (uint8_t)v[j];
+    } else if (!strcmp(argv[i], "--taps")) {
+      taps = (uint32_t)strtoul(argv[i + 1], nullptr, 10);
+    } else if (!strcmp(argv[i], "--seed")) {
+      seed = (uint32_t)strtoul(argv[i + 1], nullptr, 10);
+    } else {
+      fprintf(stderr, "opción desconocida: %s\n", argv[i]);
+      return 2;
+    }
+  }
+
+  // 1) calibrar: cuatro toques de cada botón
+  sim::reset(1);
+  Switches sw(seed);
+  for (uint8_t i = 0; i < 4; ++i) sw.bounceMs[i] = bounce[i];
+  ButtonReader reader(BUTTON_PINS, 4);
+  reader.begin();
+  BounceCalibrator cal(4);
+  cal.begin(reader.readPins(), micros());
+  wait(sw, 50, &cal, &reader);
+  for (uint8_t t = 0; t < 4 && !cal.done(); ++t) {
+    for (uint8_t b = 0; b < 4; ++b) {
+      sw.set(b, LOW);
+      wait(sw, 80, &cal, &reader);
+      sw.set(b, HIGH);
+      wait(sw, 150, &cal, &reader);
+    }
+  }
+  if (!cal.done()) {
+    fprintf(stderr, "la calibración no juntó suficientes ráfagas\n");
+    return 1;
+  }
+  uint8_t calibrated[4];
+  printf("botón  rebote  ráfagas  máx (us)  ventana (ms)  histograma 0..15 ms\n");
+  for (uint8_t b = 0; b < 4; ++b) {
+    calibrated[b] = cal.window(b);
+    printf("%5u  %4u ms  %7u  %8u  %12u  ", b + 1, bounce[b], cal.samples(b),
+           cal.maxBounceUs(b), calibrated[b]);
+    for (uint8_t k = 0; k < BounceCalibrator::kBins; ++k) printf("%u ", cal.bin(b, k));
+    printf("\n");
+  }
+
+  // 2) toques rápidos con cada ventana
+  const uint8_t fixed25[4] = {25, 25, 25, 25};
+  const uint8_t fixed5[4] = {5, 5, 5, 5};
+  const char* names[3] = {"fija 25 ms", "fija 5 ms", "calibrada"};
+  const uint8_t* windows[3] = {fixed25, fixed5, calibrated};
+  printf("\n%-12s %8s %9s %9s %13s %12s\n", "ventana", "toques", "perdidos",
+         "de más", "demora media", "demora máx");
+  for (int c = 0; c < 3; ++c) {
+    TapStats st = tapRun(bounce, windows[c], taps, seed + 1);
+    uint32_t seen = st.taps - st.missed;
+    printf("%-12s %8u %9u %9u %10.2f ms %9.1f ms\n", names[c], st.taps,
+           st.missed, st.extra, seen ? st.latencyUs / 1000.0 / seen : 0.0,
+           st.maxLatencyUs / 1000.0);
+  }
+  return 0;
+}
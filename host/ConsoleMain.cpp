@@ -0,0 +1,102 @@
+// Consola del sketch (Console.h) en la PC: las órdenes salen de la entrada
+// estándar y las respuestas van a la salida, con el reloj virtual.
+//
+//   simon_console [--eeprom imagen.bin] [--games N] [--errors PM] [--tail MS] < ordenes.txt
+//
+// Los bytes llegan al Serial a 115200 baudios (uno cada 87 µs) mientras
+// loop() sigue corriendo. Con --games un jugador sintético juega a la vez,
+// para que stats y bench midan algo (--errors: cuántos pasos de cada mil
+// erra). --eeprom carga la EEPROM de un archivo
+// al arrancar y la guarda al salir (como apagar y prender la placa).
+
+#include "Sim.h"
+#include "Player.h"
+#include "../Pins.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+
+void setup();
+void loop();
+
+static const uint64_t kByteUs = 87;
+
+static void onSerialTx(uint8_t c, void*) {
+  if (c != '\r') putchar(c);
+}
+
+int main(int argc, char** argv) {
+  const char* eepromPath = nullptr;
+  uint32_t games = 0;
+  unsigned long tailMs = 2000;
+  PlayerConfig cfg;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    if (!strcmp(argv[i], "--eeprom")) eepromPath = argv[i + 1];
+    else if (!strcmp(argv[i], "--games")) games = (uint32_t)strtoul(argv[i + 1], nullptr, 10);
+    else if (!strcmp(argv[i], "--errors")) cfg.errorPermille = (uint16_t)atoi(argv[i + 1]);
+    else if (!strcmp(argv[i], "--tail")) tailMs = strtoul(argv[i + 1], nullptr, 10);
+    else {
+      fprintf(stderr, "opción desconocida: %s\n", argv[i]);
+      return 2;
+    }
+  }
+
+  std::string input;
+  int ch;
+  while ((ch = getchar()) != EOF) input += (char)ch;
+
+  sim::reset(1);
+  sim::Eeprom& ee = sim::board().eeprom;
+  if (eepromPath) {
+    FILE* f = fopen(eepromPath, "rb");
+    if (f) {
+      if (fread(ee.data, 1, sizeof(ee.data), f) != sizeof(ee.data)) {
+        fprintf(stderr, "%s: imagen incompleta\n", eepromPath);
+      }
+      fclose(f);
+    }
+  }
+  sim::board().serialTx = onSerialTx;
+
+  SyntheticPlayer player(BUTTON_PINS, LED_PINS, 4, cfg);
+  player.setGamesToPlay(games);
+
+  setup();
+  size_t sent = 0;
+  uint64_t lineFreeUs = 0;
+  uint64_t endUs = 0;
+  for (;;) {
+    uint64_t now = sim::board().nowUs;
+    while (sent < input.size() && lineFreeUs <= now) {
+      uint8_t c = (uint8_t)input[sent];
+      if (sim::serialInput(&c, 1) == 0) break;
+      ++sent;
+      lineFreeUs = (lineFreeUs > now ? lineFreeUs : now) + kByteUs;
+    }
+    if (sent == input.size() && !endUs) endUs = now + tailMs * 1000;
+    if (endUs && now >= endUs && (games == 0 || player.done())) break;
+
+    loop();
+    if (games) player.update();
+    sim::advance(200);
+  }
+  fflush(stdout);
+
+  if (eepromPath) {
+    FILE* f = fopen(eepromPath, "wb");
+    if (!f || fwrite(ee.data, 1, sizeof(ee.data), f) != sizeof(ee.data)) {
+      fprintf(stderr, "no se pudo guardar %s\n", eepromPath);
+      return 1;
+    }
+    fclose(f);
+  }
+  fprintf(stderr, "%.1f s virtuales, %u bytes de EEPROM grabados\n",
+          sim::board().nowUs / 1e6, ee.writes);
+  const PlayerStats& ps = player.stats();
+  if (ps.games) {
+    fprintf(stderr, "jugador: %u partidas, %u ganadas, nivel medio %.2f\n", ps.games, ps.wins,
+            (double)ps.levelSum / ps.games);
+  }
+  return 0;
+}
@@ -0,0 +1,162 @@
+// Equivalencia entre el juego de referencia (los periféricos del sketch) y
+// una configuración candidata (otros periféricos, ver Backends.h). Cada uno
+// corre en su propia placa simulada; un jugador sintético juega sobre la de
+// referencia y sus botones se copian a la otra, así las dos reciben las
+// mismas entradas en el mismo instante. Después de cada pasada de loop() se
+// comparan los pines de salida, el tono, lo que se ve en el LCD, el estado
+// del juego y el reloj virtual; la primera diferencia se informa con el
+// momento y las dos pantallas, y el programa sale con 1.
+//
+//   simon_diff [--cand placa|contados|compacto|sin-lcd] [--games N] [--win N]
+//              [--errors PM] [--bounce MS] [--seed S] [--lcd-time]
+//
+// Por defecto las transferencias al LCD no gastan tiempo (Board::lcdFree):
+// una candidata que escribe menos en el LCD no corre el reloj y se la
+// compara por lo que hace, no por lo que tarda. Con --lcd-time se cuenta
+// igual que en el sketch. "sin-lcd" no escribe nada y sirve para ver cómo
+// se informa una diferencia.
+
+#include "Sim.h"
+#include "LiquidCrystal.h"
+#include "Player.h"
+#include "Station.h"
+#include "Backends.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+
+struct DiffOptions {
+  uint32_t games = 200;
+  uint8_t winScore = 20;    // partidas largas
+  PlayerConfig player;
+  bool lcdTime = false;
+};
+
+static void visible(const LiquidCrystal& lcd, char rows[2][17]) {
+  for (uint8_t r = 0; r < 2; ++r) {
+    lcd.visibleRow(r, rows[r]);
+    rows[r][16] = '\0';
+  }
+}
+
+template <typename Cand>
+static int run(const DiffOptions& opt) {
+  typedef std::chrono::steady_clock Clock;
+  sim::Board refBoard, candBoard;
+  sim::use(&candBoard);
+  sim::reset(1);
+  candBoard.lcdFree = !opt.lcdTime;
+  BasicStation<ClassicMode, Cand> cand;
+  cand.begin();
+  cand.game.setWinScore(opt.winScore);
+  sim::use(&refBoard);
+  sim::reset(1);
+  refBoard.lcdFree = !opt.lcdTime;
+  BasicStation<ClassicMode> ref;
+  ref.begin();
+  ref.game.setWinScore(opt.winScore);
+
+  SyntheticPlayer player(BUTTON_PINS, LED_PINS, 4, opt.player);
+  player.setGamesToPlay(opt.games);
+
+  uint64_t ticks = 0;
+  unsigned long refLcd = ~0UL, candLcd = ~0UL;
+  char refRows[2][17], candRows[2][17];
+  const char* what = nullptr;
+  uint8_t pin = 0;
+  Clock::time_point t0 = Clock::now();
+
+  while (!player.done()) {
+    sim::use(&refBoard);
+    player.update();
+    memcpy(candBoard.in, refBoard.in, sizeof(refBoard.in));
+    ref.game.loop();
+    sim::advance(200);
+    sim::use(&candBoard);
+    cand.game.loop();
+    sim::advance(200);
+    ++ticks;
+
+    if (ref.game.state() != cand.game.state()) what = "estado";
+    else if (refBoard.nowUs != candBoard.nowUs) what = "reloj";
+    else if (refBoard.toneFreq != candBoard.toneFreq) what = "tono";
+    for (uint8_t p = 0; !what && p < sim::kPins; ++p) {
+      if (refBoard.mode[p] == OUTPUT && refBoard.out[p] != candBoard.out[p]) {
+        what = "pin";
+        pin = p;
+      }
+    }
+    // el LCD se vuelve a leer solo si alguno escribió algo
+    if (!what && (ref.lcd.busTransfers() != refLcd || cand.lcd.busTransfers() != candLcd)) {
+      refLcd = ref.lcd.busTransfers();
+      candLcd = cand.lcd.busTransfers();
+      visible(ref.lcd, refRows);
+      visible(cand.lcd, candRows);
+      if (memcmp(refRows, candRows, sizeof(refRows))) what = "LCD";
+    }
+    if (what) break;
+  }
+  sim::use(nullptr);
+
+  double secs = std::chrono::duration<double>(Clock::now() - t0).count();
+  printf("%llu pasadas, %.1f s virtuales, %.2f M pasadas/s, %u partidas\n",
+         (unsigned long long)ticks, refBoard.nowUs / 1e6, ticks / secs / 1e6,
+         player.stats().games);
+  if (!what) {
+    printf("sin diferencias\n");
+    return 0;
+  }
+
+  visible(ref.lcd, refRows);
+  visible(cand.lcd, candRows);
+  printf("primera diferencia (%s) en la pasada %llu, %.3f s\n", what,
+         (unsigned long long)ticks, refBoard.nowUs / 1e6);
+  printf("            %-18s %-18s\n", "referencia", "candidata");
+  printf("  estado    %-18s %-18s\n", stateName(ref.game.state()), stateName(cand.game.state()));
+  printf("  reloj     %-18llu %-18llu\n", (unsigned long long)refBoard.nowUs,
+         (unsigned long long)candBoard.nowUs);
+  printf("  tono      %-18u %-18u\n", refBoard.toneFreq, candBoard.toneFreq);
+  if (!strcmp(what, "pin")) {
+    printf("  pin %-5u %-18u %-18u\n", pin, refBoard.out[pin], candBoard.out[pin]);
+  }
+  for (uint8_t r = 0; r < 2; ++r) {
+    printf("  LCD %u    \"%s\"   \"%s\"\n", r, refRows[r], candRows[r]);
+  }
+  return 1;
+}
+
+int main(int argc, char** argv) {
+  DiffOptions opt;
+  opt.player.errorPermille = 30;
+  opt.player.bounceMs = 3;
+  const char* cand = "placa";
+  for (int i = 1; i < argc; ++i) {
+    if (!strcmp(argv[i], "--lcd-time")) {
+      opt.lcdTime = true;
+      continue;
+    }
+    if (i + 1 >= argc) {
+      fprintf(stderr, "falta el valor de %s\n", argv[i]);
+      return 2;
+    }
+    const char* v = argv[++i];
+    if (!strcmp(argv[i - 1], "--cand")) cand = v;
+    else if (!strcmp(argv[i - 1], "--games")) opt.games = (uint32_t)strtoul(v, nullptr, 10);
+    else if (!strcmp(argv[i - 1], "--win")) opt.winScore = (uint8_t)atoi(v);
+    else if (!strcmp(argv[i - 1], "--errors")) opt.player.errorPermille = (uint16_t)atoi(v);
+    else if (!strcmp(argv[i - 1], "--bounce")) opt.player.bounceMs = (uint8_t)atoi(v);
+    else if (!strcmp(argv[i - 1], "--seed")) opt.player.seed = (uint32_t)strtoul(v, nullptr, 10);
+    else {
+      fprintf(stderr, "opción desconocida: %s\n", argv[i - 1]);
+      return 2;
+    }
+  }
+
+  if (!strcmp(cand, "placa")) return run<ArduinoPeripherals>(opt);
+  if (!strcmp(cand, "contados")) return run<CountingPeripherals>(opt);
+  if (!strcmp(cand, "compacto")) return run<CompactPeripherals>(opt);
+  if (!strcmp(cand, "sin-lcd")) return run<HeadlessPeripherals>(opt);
+  fprintf(stderr, "candidata desconocida: %s\n", cand);
+  return 2;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+// EEPROM.h para el simulador: misma API que la librería de Arduino, sobre
+// sim::Board::eeprom. Las escrituras cuestan su tiempo en el reloj virtual.
+
+#include "Arduino.h"
+
+class EEPROMClass {
+public:
+  uint8_t read(int idx);
+  void write(int idx, uint8_t val);
+  void update(int idx, uint8_t val);   // solo graba si cambia
+  uint16_t length();
+
+  template <typename T>
+  T& get(int idx, T& t) {
+    uint8_t* p = (uint8_t*)&t;
+    for (uint16_t i = 0; i < sizeof(T); ++i) p[i] = read(idx + i);
+    return t;
+  }
+
+  template <typename T>
+  const T& put(int idx, const T& t) {
+    const uint8_t* p = (const uint8_t*)&t;
+    for (uint16_t i = 0; i < sizeof(T); ++i) update(idx + i, p[i]);
+    return t;
+  }
+};
+
+extern EEPROMClass EEPROM;
+
+// Acceso a los registros, para la escritura diferida (EepromQueue.h): en
+// el AVR son EEAR/EEDR/EECR. eepromReadNow() no espera a que termine una
+// grabación; eepromStartWrite() solo con la EEPROM libre.
+uint8_t eepromReadNow(uint16_t addr);
+void eepromStartWrite(uint16_t addr, uint8_t value);
+
+// Hasta que termine la grabación en curso (avanza el reloj virtual)
+void eepromWaitIdle();
+
+// EERIE: con la interrupción habilitada, el simulador llama a la función
+// de eepromSetReadyIsr() cada vez que la EEPROM queda libre (lo que en el
+// AVR es ISR(EE_READY_vect))
+void eepromReadyInterrupt(bool on);
+void eepromSetReadyIsr(void (*isr)());
@@ -0,0 +1,171 @@
+// Escritura a la EEPROM desde loop(): EEPROM.put() de siempre contra la cola
+// diferida (EepromQueue.h) que graba desde EE_READY.
+//
+//   simon_eeprom_bench [--minutes M] [--changed N] [--seed S] [--check]
+//
+// Cada 5 s se guarda un bloque de configuración de 18 bytes con N bytes
+// distintos, y cada 500 ms un contador de 4 bytes (las mismas direcciones:
+// en la cola se juntan si todavía no se grabaron). Se mide cuánto tarda
+// cada llamada dentro de loop() y, con la cola, la profundidad y la demora
+// hasta grabarse.
+//
+// --check comprueba además que loadConfig() a través de la cola lea lo que
+// se acaba de guardar aunque todavía no esté grabado, sin esperar a que la
+// cola se vacíe (sale con 1 si no).
+
+#include "Sim.h"
+#include "EEPROM.h"
+#include "../EepromQueue.h"
+#include "../Config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static EepromQueue queue;
+
+static void eeReadyIsr() {
+  queue.service();
+}
+
+struct Block {
+  uint8_t b[18];
+};
+
+struct Result {
+  uint64_t stallUs = 0, worstUs = 0;
+  uint32_t calls = 0, writes = 0;
+};
+
+static Result run(bool useQueue, unsigned minutes, unsigned changed, uint32_t seed) {
+  sim::reset(1);
+  sim::Board& board = sim::board();
+  board.eeprom = sim::Eeprom();
+  queue = EepromQueue();
+  eepromSetReadyIsr(useQueue ? eeReadyIsr : nullptr);
+
+  srand(seed);
+  Block cfg;
+  memset(&cfg, 0, sizeof(cfg));
+  uint32_t counter = 0;
+  Result r;
+  uint64_t endUs = (uint64_t)minutes * 60 * 1000000;
+  unsigned long nextCfg = 5000, nextCounter = 500;
+  while (board.nowUs < endUs) {
+    unsigned long now = millis();
+    uint64_t t0 = board.nowUs;
+    bool called = false;
+    if ((long)(now - nextCfg) >= 0) {
+      nextCfg += 5000;
+      for (unsigned k = 0; k < changed; ++k) cfg.b[rand() % sizeof(cfg.b)] ^= (uint8_t)(1 + rand() % 255);
+      if (useQueue) queue.put(16, cfg);
+      else EEPROM.put(16, cfg);
+      called = true;
+    }
+    if ((long)(now - nextCounter) >= 0) {
+      nextCounter += 500;
+      ++counter;
+      if (useQueue) queue.put(64, counter);
+      else EEPROM.put(64, counter);
+      called = true;
+    }
+    if (called) {
+      uint64_t us = board.nowUs - t0;
+      ++r.calls;
+      r.stallUs += us;
+      if (us > r.worstUs) r.worstUs = us;
+    }
+    sim::advance(200);
+  }
+  r.writes = board.eeprom.writes;
+  eepromSetReadyIsr(nullptr);
+  return r;
+}
+
+// save y load enseguida, con la cola a medio vaciar y después vacía
+static bool checkLoad() {
+  sim::reset(1);
+  sim::board().eeprom = sim::Eeprom();
+  queue = EepromQueue();
+  eepromSetReadyIsr(eeReadyIsr);
+  bool ok = true;
+  const uint16_t values[3] = {300, 500, 700};
+  for (uint8_t i = 0; i < 3; ++i) {
+    SimonConfig saved;
+    memset(&saved, 0, sizeof(saved));
+    saved.onMs = values[i];
+    saved.winScore = (uint8_t)(10 + i);
+    if (!saveConfig(saved, queue, Clock::now())) {
+      printf("check: save %u sin lugar en la cola\n", i);
+      ok = false;
+      continue;
+    }
+    // enseguida, a la mitad y al final de la grabación
+    const unsigned long waitUs[3] = {0, 9 * sim::kEepromWriteUs, 20 * sim::kEepromWriteUs};
+    for (uint8_t k = 0; k < 3; ++k) {
+      sim::advance(waitUs[k]);
+      uint8_t depth = queue.depth();
+      uint64_t t0 = sim::board().nowUs;
+      SimonConfig loaded;
+      if (!loadConfig(loaded, queue) || memcmp(&loaded, &saved, sizeof(saved))) {
+        printf("check: load después del save %u con %u en la cola: otra configuración\n", i,
+               depth);
+        ok = false;
+      }
+      // a lo sumo espera la grabación en curso, no que se vacíe la cola
+      uint64_t waited = sim::board().nowUs - t0;
+      if (waited > sim::kEepromWriteUs) {
+        printf("check: load después del save %u esperó %llu us\n", i, (unsigned long long)waited);
+        ok = false;
+      }
+    }
+    SimonConfig direct;
+    if (!loadConfig(direct) || memcmp(&direct, &saved, sizeof(saved))) {
+      printf("check: save %u no quedó grabado\n", i);
+      ok = false;
+    }
+  }
+  eepromSetReadyIsr(nullptr);
+  printf("check: %s\n", ok ? "load a través de la cola ve cada save" : "FALLA");
+  return ok;
+}
+
+int main(int argc, char** argv) {
+  unsigned minutes = 10;
+  unsigned changed = 4;
+  uint32_t seed = 1;
+  bool check = false;
+  for (int i = 1; i < argc; ++i) {
+    if (!strcmp(argv[i], "--check")) {
+      check = true;
+      continue;
+    }
+    if (i + 1 >= argc) {
+      fprintf(stderr, "falta el valor de %s\n", argv[i]);
+      return 2;
+    }
+    if (!strcmp(argv[i], "--minutes")) minutes = (unsigned)atoi(argv[i + 1]);
+    else if (!strcmp(argv[i], "--changed")) changed = (unsigned)atoi(argv[i + 1]);
+    else if (!strcmp(argv[i], "--seed")) seed = (uint32_t)strtoul(argv[i + 1], nullptr, 10);
+    else {
+      fprintf(stderr, "opción desconocida: %s\n", argv[i]);
+      return 2;
+    }
+    ++i;
+  }
+
+  const char* names[2] = {"EEPROM.put", "cola"};
+  printf("%-11s %8s %12s %12s %10s\n", "escritura", "llamadas", "media (us)", "peor (us)",
+         "grabados");
+  for (int q = 0; q < 2; ++q) {
+    Result r = run(q == 1, minutes, changed, seed);
+    printf("%-11s %8u %12.1f %12llu %10u\n", names[q], r.calls,
+           r.calls ? (double)r.stallUs / r.calls : 0.0, (unsigned long long)r.worstUs,
+           r.writes);
+  }
+  printf("cola: máx %u de %u entradas, %u grabados, %u iguales salteados, "
+         "%u juntados, %u sin lugar, demora media %u ms, máx %u ms\n",
+         queue.maxDepth(), EepromQueue::kSize, queue.committed(), queue.skipped(),
+         queue.coalesced(), queue.overflows(), queue.latencyAvgMs(), queue.latencyMaxMs());
+  if (check && !checkLoad()) return 1;
+  return 0;
+}
@@ -0,0 +1,124 @@
+#include "Energy.h"
+#include "LiquidCrystal.h"
+
+#include <stdlib.h>
+
+static const char* const kPartNames[kEnergyParts] = {
+  "cpu", "sueno", "leds", "lcd", "luz", "buzzer", "eeprom", "placa"
+};
+
+const char* partName(EnergyPart p) {
+  return (uint8_t)p < kEnergyParts ? kPartNames[(uint8_t)p] : "?";
+}
+
+bool PowerModel::parse(const char* spec) {
+  double* fields[kEnergyParts] = {
+    &cpuMa, &sleepMa, &ledMa, &lcdMa, &backlightMa, &buzzerMa, &eepromMa, &boardMa
+  };
+  while (*spec) {
+    const char* eq = strchr(spec, '=');
+    if (!eq) return false;
+    size_t len = (size_t)(eq - spec);
+    char* end;
+    double v = strtod(eq + 1, &end);
+    if (end == eq + 1) return false;
+    if (len == 9 && !strncmp(spec, "luz-sigue", 9)) {
+      backlightSwitched = v != 0;
+    } else {
+      uint8_t i = 0;
+      while (i < kEnergyParts && (strlen(kPartNames[i]) != len || strncmp(spec, kPartNames[i], len))) ++i;
+      if (i == kEnergyParts) return false;
+      *fields[i] = v;
+    }
+    spec = *end == ',' ? end + 1 : end;
+    if (*end && *end != ',') return false;
+  }
+  return true;
+}
+
+double EnergyTotals::mAh() const {
+  double sum = 0;
+  for (uint8_t i = 0; i < kEnergyParts; ++i) sum += mAus[i];
+  return sum / 3.6e9;
+}
+
+EnergyTotals EnergyTotals::since(const EnergyTotals& b) const {
+  EnergyTotals d;
+  for (uint8_t i = 0; i < kEnergyParts; ++i) d.mAus[i] = mAus[i] - b.mAus[i];
+  d.awakeUs = awakeUs - b.awakeUs;
+  d.asleepUs = asleepUs - b.asleepUs;
+  return d;
+}
+
+EnergyMeter::EnergyMeter(const PowerModel& model)
+  : model_(model), ledCount_(0), board_(nullptr), eepromWrites_(0) {}
+
+EnergyMeter::~EnergyMeter() {
+  detach();
+}
+
+void EnergyMeter::addLeds(const uint8_t* pins, uint8_t count) {
+  for (uint8_t i = 0; i < count; ++i) {
+    if (ledCount_ < kMaxLeds && pins[i] < sim::kPins) ledPins_[ledCount_++] = pins[i];
+  }
+}
+
+void EnergyMeter::attach() {
+  detach();
+  board_ = &sim::board();
+  board_->onInterval = onInterval;
+  board_->onIntervalCtx = this;
+  eepromWrites_ = board_->eeprom.writes;
+}
+
+void EnergyMeter::detach() {
+  if (!board_) return;
+  if (board_->onIntervalCtx == this) board_->onInterval = nullptr;
+  board_ = nullptr;
+}
+
+void EnergyMeter::onInterval(unsigned long us, void* ctx) {
+  ((EnergyMeter*)ctx)->interval(us);
+}
+
+void EnergyMeter::interval(unsigned long us) {
+  const sim::Board& b = *board_;
+  double* q = totals_.mAus;
+
+  if (b.asleep) {
+    q[(uint8_t)EnergyPart::Sleep] += model_.sleepMa * us;
+    totals_.asleepUs += us;
+  } else {
+    q[(uint8_t)EnergyPart::Cpu] += model_.cpuMa * us;
+    totals_.awakeUs += us;
+  }
+
+  uint8_t lit = 0;
+  for (uint8_t i = 0; i < ledCount_; ++i) {
+    uint8_t p = ledPins_[i];
+    if (b.mode[p] == OUTPUT && b.out[p] == HIGH) ++lit;
+  }
+  q[(uint8_t)EnergyPart::Leds] += model_.ledMa * lit * us;
+
+  if (b.lcd) {
+    q[(uint8_t)EnergyPart::Lcd] += model_.lcdMa * us;
+    if (!model_.backlightSwitched || b.lcd->isOn()) {
+      q[(uint8_t)EnergyPart::Backlight] += model_.backlightMa * us;
+    }
+  }
+
+  // el tono puede terminar a mitad del intervalo
+  if (b.toneFreq) {
+    uint64_t on = us;
+    if (b.toneEndUs) on = b.toneEndUs > b.nowUs ? b.toneEndUs - b.nowUs : 0;
+    if (on > us) on = us;
+    q[(uint8_t)EnergyPart::Buzzer] += model_.buzzerMa * (double)on;
+  }
+
+  // cada byte grabado cuesta lo mismo; se cobra cuando aparece
+  uint32_t writes = b.eeprom.writes - eepromWrites_;
+  eepromWrites_ = b.eeprom.writes;
+  q[(uint8_t)EnergyPart::Eeprom] += model_.eepromMa * sim::kEepromWriteUs * writes;
+
+  q[(uint8_t)EnergyPart::Board] += model_.boardMa * us;
+}
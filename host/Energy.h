@@ -0,0 +1,91 @@
+#pragma once
+
+// Consumo en el simulador: EnergyMeter integra la corriente de cada parte
+// de la placa sobre el reloj virtual (Board::onInterval) según un
+// PowerModel. Cada intervalo se cobra con el estado que tenía la placa al
+// empezar (pines, tono, LCD, si el sketch durmió), que es el que dura
+// todo el advance().
+//
+// Las corrientes por defecto son de hoja de datos, a 5 V y 16 MHz, sin el
+// regulador ni el conversor USB del Uno (una placa a batería no los
+// tiene; se suman con "placa"). Sirven para comparar versiones del sketch
+// entre sí, no para predecir la batería con precisión.
+
+#include "Sim.h"
+
+struct PowerModel {
+  double cpuMa = 9.5;         // ATmega328P despierto
+  double sleepMa = 3.6;       // en SLEEP_MODE_IDLE
+  double ledMa = 13.6;        // cada LED: (5 V - 2 V) / 220 Ω
+  double lcdMa = 1.5;         // lógica del HD44780
+  double backlightMa = 20.0;
+  double buzzerMa = 18.0;     // mientras suena
+  double eepromMa = 3.0;      // extra mientras graba un byte
+  double boardMa = 0.0;       // regulador, conversor USB, ...
+  // la luz de fondo sigue a display()/noDisplay() (con un transistor);
+  // si no, está prendida siempre que haya LCD
+  bool backlightSwitched = false;
+
+  // "clave=valor,clave=valor" con las claves de partName() y "luz-sigue";
+  // false si hay alguna que no se conoce (lo anterior queda aplicado)
+  bool parse(const char* spec);
+};
+
+enum class EnergyPart : uint8_t {
+  Cpu,
+  Sleep,
+  Leds,
+  Lcd,
+  Backlight,
+  Buzzer,
+  Eeprom,
+  Board,
+  Count
+};
+
+const uint8_t kEnergyParts = (uint8_t)EnergyPart::Count;
+
+const char* partName(EnergyPart p);
+
+// Carga acumulada (mA·µs por parte) y tiempos
+struct EnergyTotals {
+  double mAus[kEnergyParts] = {0};
+  uint64_t awakeUs = 0;
+  uint64_t asleepUs = 0;
+
+  double mAh(EnergyPart p) const { return mAus[(uint8_t)p] / 3.6e9; }
+  double mAh() const;
+  uint64_t us() const { return awakeUs + asleepUs; }
+
+  // lo que pasó entre b (antes) y esto
+  EnergyTotals since(const EnergyTotals& b) const;
+};
+
+class EnergyMeter {
+public:
+  explicit EnergyMeter(const PowerModel& model = PowerModel());
+  ~EnergyMeter();
+
+  static const uint8_t kMaxLeds = 16;
+
+  // Los pines que tienen un LED (los demás no se cobran)
+  void addLeds(const uint8_t* pins, uint8_t count);
+
+  // Empieza a medir en la placa activa (usa Board::onInterval)
+  void attach();
+  void detach();
+
+  const EnergyTotals& totals() const { return totals_; }
+  const PowerModel& model() const { return model_; }
+
+private:
+  PowerModel model_;
+  EnergyTotals totals_;
+  uint8_t ledPins_[kMaxLeds];
+  uint8_t ledCount_;
+  sim::Board* board_;
+  uint32_t eepromWrites_;
+
+  static void onInterval(unsigned long us, void* ctx);
+  void interval(unsigned long us);
+};
@@ -0,0 +1,211 @@
+// Consumo del juego en el simulador (Energy.h). Cada variante juega las
+// mismas partidas con el modo de atracción y el planificador como en el
+// sketch, y después queda sin tocar; se informa cuánto gasta una partida
+// (de apretar para empezar a volver a IDLE) y una hora de reposo, por
+// parte de la placa, y cuánto dura una batería en cada caso.
+//
+//   simon_energy [--games N] [--win N] [--idle-min M] [--seed S]
+//                [--battery MAH] [--model clave=valor,...]
+//
+// En cada partida el jugador se equivoca a propósito en una ronda al azar
+// entre 1 y la del puntaje para ganar, o gana; las rondas son las mismas
+// para todas las variantes. --model cambia las corrientes (en mA) de
+// PowerModel: cpu, sueno, leds, lcd, luz, buzzer, eeprom, placa y
+// luz-sigue=1 (la luz de fondo se apaga con noDisplay()).
+
+#include "Sim.h"
+#include "Station.h"
+#include "Energy.h"
+#include "../Scheduler.h"
+#include "../Attract.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+struct EnergyOptions {
+  uint32_t games = 50;
+  uint8_t winScore = WIN_SCORE;
+  uint32_t idleMin = 60;
+  uint32_t seed = 1;
+  double batteryMah = 2000;
+  PowerModel model;
+};
+
+struct EnergyResult {
+  EnergyTotals game;        // todas las partidas juntas
+  EnergyTotals idle;
+  uint32_t games = 0;
+  uint32_t wins = 0;
+};
+
+// Tiempos del jugador (ms), como los de PlayerConfig
+const unsigned long kReactionMs = 300;
+const unsigned long kHoldMs = 80;
+const unsigned long kGapMs = 120;
+const unsigned long kLookMs = 1500;       // mirando el resultado
+
+// Una pasada despierta y una dormida (el Timer0 despierta cada ms)
+const unsigned long kPassUs = 200;
+const unsigned long kSleepPassUs = 1000;
+
+template <typename Mode>
+struct Rig {
+  typedef BasicGameController<Mode> Game;
+
+  BasicStation<Mode> st;
+  Scheduler sched;
+  BasicAttractMode<Game> attract;
+
+  Rig() : attract(sched, st.game, st.leds, st.buzzer, st.display) {}
+
+  void begin() {
+    st.begin();
+    attract.begin();
+  }
+
+  // La pasada de loop() de main.cpp
+  void pass() {
+    bool slept = attractLoopPass(st.game, attract, sched, Clock::now());
+    sim::advance(slept ? kSleepPassUs : kPassUs);
+  }
+};
+
+// Un botón apretado kHoldMs, con la pasada que corresponda mientras tanto
+template <typename Mode>
+static void press(Rig<Mode>& rig, uint8_t btn) {
+  sim::setInput(BUTTON_PINS[btn], LOW);
+  unsigned long until = millis() + kHoldMs;
+  while ((long)(millis() - until) < 0) rig.pass();
+  sim::setInput(BUTTON_PINS[btn], HIGH);
+}
+
+template <typename Mode>
+static void waitMs(Rig<Mode>& rig, unsigned long ms) {
+  unsigned long until = millis() + ms;
+  while ((long)(millis() - until) < 0) rig.pass();
+}
+
+template <typename Mode>
+static void waitState(Rig<Mode>& rig, State s) {
+  while (rig.st.game.state() != s) rig.pass();
+}
+
+// Una partida; devuelve true si ganó
+template <typename Mode>
+static bool playGame(Rig<Mode>& r, uint8_t failRound) {
+  press(r, 0);
+  for (uint8_t round = 1;; ++round) {
+    // SHOW_PATTERN hasta que pide la respuesta, o el final
+    while (r.st.game.state() != State::WAIT_INPUT && r.st.game.state() != State::GAME_OVER) {
+      r.pass();
+    }
+    if (r.st.game.state() == State::GAME_OVER) break;
+    waitMs(r, kReactionMs);
+    uint8_t len = r.st.pattern.length();
+    for (uint8_t answer = 0; r.st.game.state() == State::WAIT_INPUT; ++answer) {
+      uint8_t btn = r.st.pattern.getStep(Mode::expected(answer, len));
+      if (round == failRound) btn = (uint8_t)((btn + 1) % 4);
+      press(r, btn);
+      waitMs(r, kGapMs);
+    }
+  }
+  bool won = r.st.game.won();
+  waitMs(r, kLookMs);
+  press(r, 0);
+  waitState(r, State::IDLE);
+  return won;
+}
+
+template <typename Mode>
+static EnergyResult measure(const EnergyOptions& opt) {
+  sim::Board board;
+  sim::use(&board);
+  sim::reset(opt.seed);
+  EnergyMeter meter(opt.model);
+  meter.addLeds(LED_PINS, 4);
+  meter.attach();
+
+  Rig<Mode> rig;
+  rig.begin();
+  rig.st.game.setWinScore(opt.winScore);
+  EnergyResult res;
+
+  uint32_t rng = opt.seed ? opt.seed : 1;
+  for (uint32_t g = 0; g < opt.games; ++g) {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    uint8_t failRound = (uint8_t)(1 + rng % (opt.winScore + 1u));
+    waitMs(rig, 1000);
+    EnergyTotals t0 = meter.totals();
+    if (playGame(rig, failRound)) ++res.wins;
+    EnergyTotals d = meter.totals().since(t0);
+    for (uint8_t i = 0; i < kEnergyParts; ++i) res.game.mAus[i] += d.mAus[i];
+    res.game.awakeUs += d.awakeUs;
+    res.game.asleepUs += d.asleepUs;
+    ++res.games;
+  }
+
+  EnergyTotals t0 = meter.totals();
+  waitMs(rig, opt.idleMin * 60000UL);
+  res.idle = meter.totals().since(t0);
+
+  meter.detach();
+  sim::use(nullptr);
+  return res;
+}
+
+static void printParts(const char* what, const EnergyTotals& t) {
+  double total = t.mAh();
+  printf("           %-8s", what);
+  for (uint8_t i = 0; i < kEnergyParts; ++i) {
+    double p = t.mAh((EnergyPart)i);
+    if (p > 0) printf(" %s %.0f%%", partName((EnergyPart)i), 100.0 * p / total);
+  }
+  printf("\n");
+}
+
+static void report(const char* name, const EnergyResult& r, const EnergyOptions& opt) {
+  double gameMah = r.games ? r.game.mAh() / r.games : 0;
+  double gameS = r.games ? r.game.us() / 1e6 / r.games : 0;
+  double hours = r.idle.us() / 3.6e9;
+  double idleMah = hours > 0 ? r.idle.mAh() / hours : 0;
+  double asleep = r.idle.us() ? 100.0 * r.idle.asleepUs / r.idle.us() : 0;
+  printf("%-10s %9.4f %8.1f %9.1f %7.1f%% %9.0f %9.1f\n", name, gameMah, gameS, idleMah,
+         asleep, gameMah > 0 ? opt.batteryMah / gameMah : 0,
+         idleMah > 0 ? opt.batteryMah / idleMah : 0);
+  printParts("partida", r.game);
+  printParts("reposo", r.idle);
+}
+
+int main(int argc, char** argv) {
+  EnergyOptions opt;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    const char* v = argv[i + 1];
+    if (!strcmp(argv[i], "--games")) opt.games = (uint32_t)strtoul(v, nullptr, 10);
+    else if (!strcmp(argv[i], "--win")) opt.winScore = (uint8_t)atoi(v);
+    else if (!strcmp(argv[i], "--idle-min")) opt.idleMin = (uint32_t)strtoul(v, nullptr, 10);
+    else if (!strcmp(argv[i], "--seed")) opt.seed = (uint32_t)strtoul(v, nullptr, 10);
+    else if (!strcmp(argv[i], "--battery")) opt.batteryMah = atof(v);
+    else if (!strcmp(argv[i], "--model")) {
+      if (!opt.model.parse(v)) {
+        fprintf(stderr, "modelo inválido: %s\n", v);
+        return 2;
+      }
+    } else {
+      fprintf(stderr, "opción desconocida: %s\n", argv[i]);
+      return 2;
+    }
+  }
+  if (opt.winScore == 0) opt.winScore = 1;
+
+  printf("%u partidas (gana en %u), %u min de reposo, batería de %.0f mAh\n", opt.games,
+         opt.winScore, opt.idleMin, opt.batteryMah);
+  printf("%-10s %9s %8s %9s %8s %9s %9s\n", "variante", "mAh/part", "s/part",
+         "mA reposo", "dormido", "partidas", "h reposo");
+  report("clasico", measure<ClassicMode>(opt), opt);
+  report("reverso", measure<ReverseMode>(opt), opt);
+  report("velocidad", measure<SpeedMode>(opt), opt);
+  report("suma-dos", measure<AddTwoMode>(opt), opt);
+  return 0;
+}
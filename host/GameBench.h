@@ -0,0 +1,113 @@
+#pragma once
+
+// Lo común de simon_mode_bench y simon_periph_bench: un jugador perfecto
+// que conoce el patrón juega las mismas partidas (mismas semillas) en una
+// BasicStation<Mode, Periph>, y se mide el tiempo real que pasa dentro de
+// game.loop(). De cada configuración vale la mejor de R repeticiones
+// intercaladas, para sacar el ruido de la PC.
+
+#include "Sim.h"
+#include "Station.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+
+struct GameBenchResult {
+  uint64_t loopNs = 0;
+  uint64_t passes = 0;
+  uint64_t rounds = 0;
+  uint64_t steps = 0;       // pasos mostrados
+  uint64_t virtualUs = 0;
+  uint64_t levels = 0;      // nivel final, sumado por partida
+
+  double nsPerPass() const { return passes ? (double)loopNs / passes : 0.0; }
+};
+
+template <typename Mode, typename Periph>
+void runBenchGames(uint32_t games, GameBenchResult& res) {
+  typedef std::chrono::steady_clock HostClock;
+  sim::Board board;
+  sim::use(&board);
+  BasicStation<Mode, Periph> st;
+
+  for (uint32_t g = 0; g < games; ++g) {
+    sim::reset(g * 2654435761u + 1);
+    st.begin();
+    uint64_t startUs = board.nowUs;
+
+    // toque: apretar 60 ms, soltar 60 ms
+    uint8_t press = 0xFF, answer = 0;
+    unsigned long nextMs = millis() + 50;
+    bool down = false, started = false;
+    State last = State::IDLE;
+
+    for (uint32_t pass = 0; pass < 2000000; ++pass) {
+      unsigned long now = millis();
+      if ((long)(now - nextMs) >= 0) {
+        if (down) {
+          sim::setInput(BUTTON_PINS[press], HIGH);
+          down = false;
+          press = 0xFF;
+          nextMs = now + 60;
+        } else if (!started) {
+          press = 0;
+        } else if (st.game.state() == State::WAIT_INPUT) {
+          uint8_t len = st.pattern.length();
+          press = st.pattern.getStep(Mode::expected(answer++, len));
+        }
+        if (press != 0xFF && !down) {
+          sim::setInput(BUTTON_PINS[press], LOW);
+          down = true;
+          started = true;
+          nextMs = now + 60;
+        }
+      }
+
+      HostClock::time_point t0 = HostClock::now();
+      st.game.loop();
+      res.loopNs += (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+          HostClock::now() - t0).count();
+      ++res.passes;
+
+      State s = st.game.state();
+      if (s != last) {
+        if (s == State::SHOW_PATTERN) {
+          res.steps += st.pattern.length();
+          answer = 0;
+          if (last == State::WAIT_INPUT) ++res.rounds;
+        } else if (s == State::GAME_OVER) {
+          if (st.game.won()) ++res.rounds;
+          break;
+        }
+        last = s;
+      }
+      sim::advance(200);
+    }
+    res.virtualUs += board.nowUs - startUs;
+    res.levels += st.game.level();
+  }
+  sim::use(nullptr);
+}
+
+// Una repetición; se queda con ella si es la primera o la más rápida
+template <typename Mode, typename Periph>
+void benchBest(uint32_t games, bool first, GameBenchResult& best) {
+  GameBenchResult r;
+  runBenchGames<Mode, Periph>(games, r);
+  if (first || r.nsPerPass() < best.nsPerPass()) best = r;
+}
+
+// --games N y --reps R; false (ya avisó) si hay una opción desconocida
+inline bool parseBenchOptions(int argc, char** argv, uint32_t& games, unsigned& reps) {
+  for (int i = 1; i + 1 < argc; i += 2) {
+    if (!strcmp(argv[i], "--games")) games = (uint32_t)strtoul(argv[i + 1], nullptr, 10);
+    else if (!strcmp(argv[i], "--reps")) reps = (unsigned)atoi(argv[i + 1]);
+    else {
+      fprintf(stderr, "opción desconocida: %s\n", argv[i]);
+      return false;
+    }
+  }
+  if (reps == 0) reps = 1;
+  return true;
+}
@@ -0,0 +1,112 @@
+// Costo de ButtonReader::update() con los gestos (pulsación larga, doble
+// y acordes) para distintas formas de tocar. Los gestos salen de los
+// tiempos que ya guarda el antirrebote, así que el costo por llamada tiene
+// que quedar igual en reposo que tocando.
+//
+//   simon_gesture_bench [--seconds S] [--reps R]
+//
+// Una llamada cada 200 µs de tiempo virtual; de cada forma de tocar se toma
+// la mejor de R repeticiones.
+
+#include "Sim.h"
+#include "../Pins.h"
+#include "../Simon.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Niveles de los botones (bit i = botón i en HIGH) a los t ms de cada ciclo
+typedef uint8_t (*Script)(unsigned long t);
+
+static uint8_t idle(unsigned long) { return 0x0F; }
+
+// Un toque de 80 ms cada 400 ms, pasando por los cuatro botones
+static uint8_t taps(unsigned long t) {
+  uint8_t b = (uint8_t)((t / 400) % 4);
+  return t % 400 < 80 ? (uint8_t)(0x0F & ~(1 << b)) : 0x0F;
+}
+
+// Dos toques de 60 ms separados por 100 ms, cada 600 ms
+static uint8_t doubles(unsigned long t) {
+  unsigned long c = t % 600;
+  return (c < 60 || (c >= 160 && c < 220)) ? 0x0E : 0x0F;
+}
+
+// Botones 1 y 4 con 20 ms de diferencia, 200 ms apretados, cada 600 ms
+static uint8_t chords(unsigned long t) {
+  unsigned long c = t % 600;
+  uint8_t v = 0x0F;
+  if (c < 200) v &= 0x0E;
+  if (c >= 20 && c < 220) v &= 0x07;
+  return v;
+}
+
+// 1.5 s apretado, 0.5 s suelto
+static uint8_t holds(unsigned long t) {
+  return t % 2000 < 1500 ? 0x0D : 0x0F;
+}
+
+struct Result {
+  double ns = 0;
+  uint32_t edges = 0, longs = 0, doubles = 0, chords = 0;
+};
+
+static Result run(Script script, unsigned seconds) {
+  typedef std::chrono::steady_clock Clock;
+  sim::reset(1);
+  ButtonReader buttons(BUTTON_PINS, 4, 25);
+  buttons.begin();
+  Result r;
+  uint64_t ns = 0;
+  uint32_t calls = seconds * 5000;
+  for (uint32_t n = 0; n < calls; ++n) {
+    uint8_t levels = script(millis());
+    Clock::time_point t0 = Clock::now();
+    buttons.update(levels);
+    ns += (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        Clock::now() - t0).count();
+    for (uint8_t i = 0; i < 4; ++i) {
+      r.edges += buttons.risingEdge(i);
+      r.longs += buttons.longPress(i);
+      r.doubles += buttons.doublePress(i);
+    }
+    r.chords += buttons.chord() != 0;
+    sim::advance(200);
+  }
+  r.ns = (double)ns / calls;
+  return r;
+}
+
+int main(int argc, char** argv) {
+  unsigned seconds = 120;
+  unsigned reps = 5;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    if (!strcmp(argv[i], "--seconds")) seconds = (unsigned)atoi(argv[i + 1]);
+    else if (!strcmp(argv[i], "--reps")) reps = (unsigned)atoi(argv[i + 1]);
+    else {
+      fprintf(stderr, "opción desconocida: %s\n", argv[i]);
+      return 2;
+    }
+  }
+  if (reps == 0) reps = 1;
+
+  const char* names[5] = {"reposo", "toques", "dobles", "acordes", "largas"};
+  Script scripts[5] = {idle, taps, doubles, chords, holds};
+  Result best[5];
+  for (unsigned r = 0; r < reps; ++r) {
+    for (int i = 0; i < 5; ++i) {
+      Result x = run(scripts[i], seconds);
+      if (r == 0 || x.ns < best[i].ns) best[i] = x;
+    }
+  }
+
+  printf("%-8s %10s %8s %8s %8s %8s\n", "toque", "ns/update", "flancos", "largas",
+         "dobles", "acordes");
+  for (int i = 0; i < 5; ++i) {
+    const Result& b = best[i];
+    printf("%-8s %10.1f %8u %8u %8u %8u\n", names[i], b.ns, b.edges, b.longs,
+           b.doubles, b.chords);
+  }
+  return 0;
+}
@@ -0,0 +1,132 @@
+// Simulador en la PC: corre setup()/loop() del sketch con reloj virtual y
+// un jugador sintético.
+//
+//   ProyectoEstructuras [--games N] [--seed S] [--error PERMILLE]
+//                       [--pass-us US] [--trace salida.json]
+//                       [--record partidas.bin] [--shm /simon]
+//
+// Con --trace el búfer crece con --games; si igual se llena, la traza
+// queda incompleta y termina con 1.
+//
+// El sketch se compila con SIMON_RECORD: las líneas "REC <hex>" que manda
+// por Serial se guardan en binario con --record (ver simon_replay).
+//
+// Al final informa cuántas escrituras a los LEDs se ahorró el
+// GameController al aplicar solo los cambios de cada pasada.
+
+#include "Sim.h"
+#include "Player.h"
+#include "TraceRecorder.h"
+#include "RecordingFile.h"
+#include "ShmMirror.h"
+#include "../Pins.h"
+#include "../Simon.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+void setup();
+void loop();
+extern GameController game;
+
+struct RecordSink {
+  FILE* file = nullptr;
+  uint8_t buf[1024];
+  RecordingLineReader reader{buf, sizeof(buf)};
+  uint32_t saved = 0;
+};
+
+static void onSerialTx(uint8_t c, void* ctx) {
+  RecordSink* sink = (RecordSink*)ctx;
+  if (sink->reader.feed((char)c)) {
+    fwrite(sink->reader.data(), 1, sink->reader.size(), sink->file);
+    ++sink->saved;
+  }
+}
+
+int main(int argc, char** argv) {
+  uint32_t games = 3;
+  uint32_t seed = 1;
+  unsigned long passUs = 200;   // costo virtual de una pasada de loop()
+  const char* tracePath = nullptr;
+  const char* recordPath = nullptr;
+  const char* shmName = nullptr;
+  PlayerConfig cfg;
+
+  for (int i = 1; i + 1 < argc; i += 2) {
+    const char* key = argv[i];
+    const char* val = argv[i + 1];
+    if (!strcmp(key, "--games")) games = (uint32_t)strtoul(val, nullptr, 10);
+    else if (!strcmp(key, "--seed")) seed = (uint32_t)strtoul(val, nullptr, 10);
+    else if (!strcmp(key, "--error")) cfg.errorPermille = (uint16_t)atoi(val);
+    else if (!strcmp(key, "--pass-us")) passUs = strtoul(val, nullptr, 10);
+    else if (!strcmp(key, "--trace")) tracePath = val;
+    else if (!strcmp(key, "--record")) recordPath = val;
+    else if (!strcmp(key, "--shm")) shmName = val;
+    else {
+      fprintf(stderr, "opción desconocida: %s\n", key);
+      return 2;
+    }
+  }
+
+  // 8192 eventos por partida, más que los de una partida ganada
+  if (tracePath) {
+    uint32_t traced = games < 8 ? 8 : (games > 2048 ? 2048 : games);
+    trace::start(tracePath, traced << 13);
+  }
+
+  sim::reset(seed * 2654435761u);
+
+  RecordSink sink;
+  if (recordPath) {
+    sink.file = fopen(recordPath, "wb");
+    if (!sink.file) {
+      fprintf(stderr, "no se pudo crear %s\n", recordPath);
+      return 2;
+    }
+    sim::board().serialTx = onSerialTx;
+    sim::board().serialTxCtx = &sink;
+  }
+
+  // estado publicado para visualizadores externos (simon_shm_view)
+  ShmMirror mirror;
+  if (shmName && !mirror.open(shmName, LED_PINS, 4)) {
+    fprintf(stderr, "no se pudo abrir la memoria compartida %s\n", shmName);
+    return 2;
+  }
+
+  cfg.seed = seed;
+  SyntheticPlayer player(BUTTON_PINS, LED_PINS, 4, cfg);
+  player.setGamesToPlay(games);
+
+  setup();
+  // límite por si el juego se traba: 10 minutos virtuales por juego
+  const uint64_t limitUs = (uint64_t)games * 600000000ULL;
+  while (!player.done() && sim::board().nowUs < limitUs) {
+    loop();
+    player.update();
+    sim::advance(passUs);
+  }
+
+  const PlayerStats& st = player.stats();
+  printf("juegos: %u  ganados: %u  rondas: %u  tiempo virtual: %.1f s\n",
+         st.games, st.wins, st.rounds, sim::board().nowUs / 1e6);
+  const GameController::OutputStats& out = game.outputStats();
+  double secs = sim::board().nowUs / 1e6;
+  printf("LEDs: %llu escrituras pedidas, %llu hechas, %.1f evitadas por s\n",
+         (unsigned long long)out.requested, (unsigned long long)out.written,
+         secs > 0 ? (out.requested - out.written) / secs : 0.0);
+  if (tracePath) {
+    printf("traza: %u eventos (%u descartados) -> %s\n",
+           trace::recorded(), trace::dropped(), tracePath);
+    if (trace::dropped()) {
+      fprintf(stderr, "error: la traza se llenó, faltan %u eventos\n", trace::dropped());
+      return 1;
+    }
+  }
+  if (sink.file) {
+    fclose(sink.file);
+    printf("grabación: %u partidas -> %s\n", sink.saved, recordPath);
+  }
+  return player.done() ? 0 : 1;
+}
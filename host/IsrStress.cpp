@@ -0,0 +1,193 @@
+// Prueba de carga de IsrShared.h: un hilo hace de interrupción y otro de
+// loop(), en núcleos distintos y sin ningún otro sincronismo, así cada
+// operación puede quedar cortada por la otra en cualquier punto (más que
+// en el AVR, donde la ISR corre entera). Se comprueba:
+//
+//   ring      los valores llegan todos, en orden y sin repetirse
+//   flags     take() nunca devuelve una bandera más veces que los set()
+//             que hubo y al final no se perdió el último set() de ninguna
+//   snapshot  cada copia es de una sola escritura (los campos coinciden)
+//             y nunca va para atrás
+//
+//   simon_isr_stress [--ops N] [--seed S]
+//
+// Sale con 1 si algo falla. Los tiempos son de la PC, para comparar entre
+// versiones; los ciclos del AVR están en IsrShared.h.
+
+#include "../IsrShared.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <thread>
+
+typedef std::chrono::steady_clock Clock;
+
+static uint32_t errors;
+
+static void fail(const char* what, uint64_t at) {
+  if (errors++ < 5) printf("  error: %s (operación %llu)\n", what, (unsigned long long)at);
+}
+
+// Pausas al azar para que los dos hilos se crucen de todas las formas
+struct Jitter {
+  uint32_t x;
+  explicit Jitter(uint32_t seed) : x(seed | 1) {}
+  void operator()() {
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    if ((x & 0x3F) == 0) {
+      for (uint32_t i = 0; i < (x >> 26); ++i) __asm__ __volatile__("");
+    }
+  }
+};
+
+// Esperando al otro hilo: con un solo núcleo hay que cederle el lugar
+static void spin(uint64_t& count) {
+  if ((++count & 0xF) == 0) std::this_thread::yield();
+}
+
+static double nsPerOp(Clock::time_point t0, uint64_t ops) {
+  return std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / ops;
+}
+
+static void ring(uint64_t ops, uint32_t seed) {
+  IsrRing<uint32_t, 16> q;
+  uint64_t fullSpins = 0, emptySpins = 0;
+  Clock::time_point t0 = Clock::now();
+
+  std::thread producer([&] {
+    Jitter j(seed);
+    for (uint64_t i = 0; i < ops; ++i) {
+      while (!q.push((uint32_t)i)) spin(fullSpins);
+      j();
+    }
+  });
+  Jitter j(seed * 7);
+  for (uint64_t i = 0; i < ops; ++i) {
+    uint32_t v;
+    while (!q.pop(v)) spin(emptySpins);
+    if (v != (uint32_t)i) fail("valor fuera de orden", i);
+    j();
+  }
+  producer.join();
+  if (!q.empty()) fail("quedaron valores en la cola", ops);
+
+  printf("ring      %10llu ops    %6.1f ns/op  llena %llu  vacía %llu\n",
+         (unsigned long long)ops, nsPerOp(t0, ops),
+         (unsigned long long)fullSpins, (unsigned long long)emptySpins);
+}
+
+static void flags(uint64_t ops, uint32_t seed) {
+  IsrFlags f;
+  std::atomic<uint64_t> sets[8];
+  for (uint8_t b = 0; b < 8; ++b) sets[b] = 0;
+  std::atomic<bool> done(false);
+  uint64_t seen[8] = {0}, taken[8] = {0}, takes = 0;
+  Clock::time_point t0 = Clock::now();
+
+  std::thread isr([&] {
+    Jitter j(seed);
+    for (uint64_t i = 0; i < ops; ++i) {
+      uint8_t b = (uint8_t)((j.x >> 8) & 7);
+      sets[b].fetch_add(1, std::memory_order_relaxed);
+      f.set((uint8_t)(1u << b));
+      j();
+    }
+    done.store(true, std::memory_order_release);
+  });
+  // después de terminar el otro hilo, una vuelta más para juntar lo último
+  for (bool last = false; !last;) {
+    last = done.load(std::memory_order_acquire);
+    uint8_t got = f.take();
+    if (!got) {
+      std::this_thread::yield();
+      continue;
+    }
+    ++takes;
+    for (uint8_t b = 0; b < 8; ++b) {
+      if (!(got & (1u << b))) continue;
+      // el contador sube antes del set(): ya tiene que contar este
+      uint64_t n = sets[b].load(std::memory_order_relaxed);
+      if (++taken[b] > n) fail("bandera sin set() que la prenda", takes);
+      seen[b] = n;
+    }
+  }
+  isr.join();
+  for (uint8_t b = 0; b < 8; ++b) {
+    if (seen[b] != sets[b].load()) fail("se perdió el último set()", b);
+  }
+  if (f.peek()) fail("quedaron banderas prendidas", ops);
+
+  printf("flags     %10llu sets   %6.1f ns/op  take() con algo: %llu\n",
+         (unsigned long long)ops, nsPerOp(t0, ops), (unsigned long long)takes);
+}
+
+struct Sample {
+  uint32_t n;
+  uint32_t check;
+  uint16_t low;
+};
+
+static void snapshot(uint64_t ops, uint32_t seed) {
+  IsrSnapshot<Sample> snap;
+  std::atomic<bool> done(false);
+  uint64_t reads = 0, retries = 0;
+  Clock::time_point t0 = Clock::now();
+
+  std::thread isr([&] {
+    Jitter j(seed);
+    for (uint64_t i = 1; i <= ops; ++i) {
+      Sample s;
+      s.n = (uint32_t)i;
+      s.check = (uint32_t)i * 2654435761u;
+      s.low = (uint16_t)i;
+      snap.write(s);
+      j();
+    }
+    done.store(true, std::memory_order_release);
+  });
+  uint32_t last = 0;
+  Jitter j(seed * 7);
+  while (!done.load(std::memory_order_acquire)) {
+    Sample s;
+    retries += snap.read(s);
+    ++reads;
+    if (s.check != s.n * 2654435761u || s.low != (uint16_t)s.n) fail("copia mezclada", reads);
+    if (s.n < last) fail("el valor fue para atrás", reads);
+    last = s.n;
+    j();
+  }
+  isr.join();
+  if (snap.read().n != (uint32_t)ops) fail("no se ve la última escritura", ops);
+
+  printf("snapshot  %10llu escr.  %6.1f ns/op  lecturas %llu  reintentos %llu\n",
+         (unsigned long long)ops, nsPerOp(t0, ops), (unsigned long long)reads,
+         (unsigned long long)retries);
+}
+
+int main(int argc, char** argv) {
+  uint64_t ops = 5000000;
+  uint32_t seed = 1;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    if (!strcmp(argv[i], "--ops")) ops = strtoull(argv[i + 1], nullptr, 10);
+    else if (!strcmp(argv[i], "--seed")) seed = (uint32_t)strtoul(argv[i + 1], nullptr, 10);
+    else {
+      fprintf(stderr, "opción desconocida: %s\n", argv[i]);
+      return 2;
+    }
+  }
+  if (ops == 0) ops = 1;
+
+  ring(ops, seed);
+  flags(ops, seed);
+  snapshot(ops, seed);
+
+  if (errors) {
+    printf("%u errores\n", errors);
+    return 1;
+  }
+  printf("sin errores\n");
+  return 0;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+// LiquidCrystal para el simulador: emula la DDRAM del HD44780
+// (2 líneas de 40 columnas) y el corrimiento de la ventana visible.
+// Cada transferencia cuesta el tiempo que tarda la librería real en modo
+// de 4 bits, así que las escrituras al LCD aparecen en el reloj virtual.
+
+#include "Arduino.h"
+
+class LiquidCrystal : public Print {
+public:
+  static const uint8_t kLineLen = 40;
+  static const uint8_t kLines = 2;
+
+  LiquidCrystal(uint8_t rs, uint8_t enable,
+                uint8_t d0, uint8_t d1, uint8_t d2, uint8_t d3);
+
+  void begin(uint8_t cols, uint8_t rows);
+  void clear();
+  void home();
+  void setCursor(uint8_t col, uint8_t row);
+  void scrollDisplayLeft();
+  void scrollDisplayRight();
+  void display();
+  void noDisplay();
+  void command(uint8_t value);
+
+  size_t write(uint8_t c) override;
+  using Print::write;
+
+  // Lectura para el simulador: lo que se ve en la fila `row` (cols caracteres)
+  void visibleRow(uint8_t row, char* out) const;
+  char ddramAt(uint8_t row, uint8_t col) const { return ddram_[row][col]; }
+  uint8_t cols() const { return cols_; }
+  uint8_t rows() const { return rows_; }
+  uint8_t shift() const { return shift_; }
+  bool isOn() const { return on_; }
+
+  // Transferencias al bus (comandos + datos) desde begin()
+  unsigned long busTransfers() const { return transfers_; }
+
+private:
+  uint8_t cols_;
+  uint8_t rows_;
+  uint8_t addrRow_;
+  uint8_t addrCol_;
+  uint8_t shift_;
+  bool on_;
+  unsigned long transfers_;
+  char ddram_[kLines][kLineLen];
+
+  void transfer(unsigned long extraUs);
+};
@@ -0,0 +1,39 @@
+// Costo de las variantes del juego contra el clásico. Cada variante juega
+// las mismas partidas con un jugador perfecto que conoce el patrón, y se
+// mide el tiempo real que pasa dentro de game.loop() (GameBench.h).
+//
+//   simon_mode_bench [--games N] [--reps R]
+//
+// La variante es una política que se resuelve al compilar, así que el
+// costo por pasada de loop() tiene que quedar igual que en el clásico
+// (dentro del ruido de la medición).
+
+#include "GameBench.h"
+
+int main(int argc, char** argv) {
+  uint32_t games = 200;
+  unsigned reps = 5;
+  if (!parseBenchOptions(argc, argv, games, reps)) return 2;
+
+  const char* names[4] = {"clasico", "reverso", "velocidad", "suma-dos"};
+  GameBenchResult best[4];
+  for (unsigned r = 0; r < reps; ++r) {
+    benchBest<ClassicMode, ArduinoPeripherals>(games, r == 0, best[0]);
+    benchBest<ReverseMode, ArduinoPeripherals>(games, r == 0, best[1]);
+    benchBest<SpeedMode, ArduinoPeripherals>(games, r == 0, best[2]);
+    benchBest<AddTwoMode, ArduinoPeripherals>(games, r == 0, best[3]);
+  }
+
+  printf("%-10s %8s %8s %10s %12s %12s %8s\n",
+         "variante", "rondas", "pasos", "pasadas", "ns/pasada", "us/ronda", "vs clas.");
+  double classicNs = best[0].nsPerPass();
+  for (int i = 0; i < 4; ++i) {
+    const GameBenchResult& b = best[i];
+    printf("%-10s %8llu %8llu %10llu %12.1f %12.1f %+7.1f%%\n", names[i],
+           (unsigned long long)b.rounds, (unsigned long long)b.steps,
+           (unsigned long long)b.passes, b.nsPerPass(),
+           b.rounds ? (double)b.loopNs / b.rounds / 1000 : 0.0,
+           100.0 * (b.nsPerPass() - classicNs) / classicNs);
+  }
+  return 0;
+}
@@ -0,0 +1,45 @@
+// El GameController con otros periféricos. Las mismas partidas (jugador
+// perfecto, mismas semillas, GameBench.h) se juegan con tres juegos de
+// periféricos:
+//
+//   placa     los del sketch (ArduinoPeripherals)
+//   contados  LEDs y buzzer que cuentan cada llamada y siguen a los de la
+//             placa (heredan y tapan solo esos métodos)
+//   sin LCD   un display que no hace nada: sin los 210 us por transferencia
+//
+//   simon_periph_bench [--games N] [--reps R]
+//
+// Los periféricos se eligen al compilar, así que "contados" tiene que
+// costar lo mismo que "placa" por pasada de loop() (dentro del ruido) y
+// las tres tienen que terminar igual: el display no cambia el juego.
+
+#include "GameBench.h"
+#include "Backends.h"
+
+int main(int argc, char** argv) {
+  uint32_t games = 200;
+  unsigned reps = 5;
+  if (!parseBenchOptions(argc, argv, games, reps)) return 2;
+
+  const char* names[3] = {"placa", "contados", "sin LCD"};
+  GameBenchResult best[3];
+  for (unsigned r = 0; r < reps; ++r) {
+    backendCounts = BackendCounts();
+    benchBest<ClassicMode, ArduinoPeripherals>(games, r == 0, best[0]);
+    benchBest<ClassicMode, CountingPeripherals>(games, r == 0, best[1]);
+    benchBest<ClassicMode, HeadlessPeripherals>(games, r == 0, best[2]);
+  }
+
+  printf("%-9s %10s %12s %10s %12s %8s\n",
+         "perif.", "pasadas", "ns/pasada", "vs placa", "s/partida", "niveles");
+  for (int i = 0; i < 3; ++i) {
+    const GameBenchResult& b = best[i];
+    printf("%-9s %10llu %12.1f %+9.1f%% %12.3f %8llu\n", names[i],
+           (unsigned long long)b.passes, b.nsPerPass(),
+           100.0 * (b.nsPerPass() - best[0].nsPerPass()) / best[0].nsPerPass(),
+           (double)b.virtualUs / 1e6 / games, (unsigned long long)b.levels);
+  }
+  printf("contados, por partida: %.1f llamadas a los LEDs, %.1f sonidos\n",
+         (double)backendCounts.leds / games, (double)backendCounts.sounds / games);
+  return 0;
+}
@@ -0,0 +1,151 @@
+#include "Player.h"
+#include "LiquidCrystal.h"
+
+#include <stdlib.h>
+
+SyntheticPlayer::SyntheticPlayer(const uint8_t* buttonPins, const uint8_t* ledPins,
+                                 uint8_t count, const PlayerConfig& cfg)
+  : buttonPins_(buttonPins), ledPins_(ledPins), count_(count), cfg_(cfg),
+    gamesLeft_(1), rng_(cfg.seed ? cfg.seed : 1), lcd_(nullptr),
+    phase_(Phase::Idle), level_(0), levelStartMs_(0), prevLeds_(0),
+    ledOnMs_(0), shortestOnMs_(0),
+    seqLen_(0),
+    queueLen_(0), queuePos_(0), holding_(false), nextActionMs_(0),
+    bouncePin_(0xFF), bounceLevel_(HIGH), bounceUntilMs_(0) {}
+
+uint32_t SyntheticPlayer::nextRand() {
+  // xorshift32: no toca el random() del sketch
+  rng_ ^= rng_ << 13;
+  rng_ ^= rng_ >> 17;
+  rng_ ^= rng_ << 5;
+  return rng_;
+}
+
+uint8_t SyntheticPlayer::readLeds() const {
+  uint8_t mask = 0;
+  for (uint8_t i = 0; i < count_; ++i) {
+    if (sim::pinLevel(ledPins_[i]) == HIGH) mask |= (uint8_t)(1u << i);
+  }
+  return mask;
+}
+
+void SyntheticPlayer::queuePress(uint8_t btn, unsigned long atMs) {
+  if (queueLen_ == 0) nextActionMs_ = atMs;
+  if (queueLen_ < kMaxSeq) queue_[queueLen_++] = btn;
+}
+
+void SyntheticPlayer::press(uint8_t pin, uint8_t level, unsigned long now) {
+  if (bouncePin_ != 0xFF && bouncePin_ != pin) sim::setInput(bouncePin_, bounceLevel_);
+  bouncePin_ = 0xFF;
+  sim::setInput(pin, level);
+  if (cfg_.bounceMs) {
+    bouncePin_ = pin;
+    bounceLevel_ = level;
+    bounceUntilMs_ = now + cfg_.bounceMs;
+  }
+}
+
+void SyntheticPlayer::runQueue(unsigned long now) {
+  // el contacto rebota al azar hasta asentarse
+  if (bouncePin_ != 0xFF) {
+    if (now < bounceUntilMs_) {
+      sim::setInput(bouncePin_, (nextRand() & 1) ? HIGH : LOW);
+    } else {
+      sim::setInput(bouncePin_, bounceLevel_);
+      bouncePin_ = 0xFF;
+    }
+  }
+  if (queuePos_ >= queueLen_ || now < nextActionMs_) return;
+  uint8_t pin = buttonPins_[queue_[queuePos_]];
+  if (!holding_) {
+    press(pin, LOW, now);
+    holding_ = true;
+    nextActionMs_ = now + cfg_.holdMs;
+  } else {
+    press(pin, HIGH, now);
+    holding_ = false;
+    nextActionMs_ = now + cfg_.gapMs;
+    if (++queuePos_ >= queueLen_) queueLen_ = queuePos_ = 0;
+  }
+}
+
+void SyntheticPlayer::update() {
+  unsigned long now = millis();
+  runQueue(now);
+
+  const LiquidCrystal* lcd = lcd_ ? lcd_ : sim::board().lcd;
+  if (!lcd) return;
+  char row[LiquidCrystal::kLineLen + 1];
+  lcd->visibleRow(0, row);
+
+  uint8_t leds = readLeds();
+  uint8_t rising = (uint8_t)(leds & ~prevLeds_);
+  uint8_t falling = (uint8_t)(prevLeds_ & ~leds);
+  prevLeds_ = leds;
+
+  bool busy = queueLen_ != 0;
+
+  if (strncmp(row, "Nivel: ", 7) == 0) {
+    uint8_t level = (uint8_t)atoi(row + 7);
+    if (level != level_ || phase_ == Phase::Idle || phase_ == Phase::Finished) {
+      if (level_ != 0 && level == level_ + 1) {
+        ++stats_.rounds;
+        stats_.roundMsSum += now - levelStartMs_;
+      }
+      level_ = level;
+      levelStartMs_ = now;
+      seqLen_ = 0;
+      shortestOnMs_ = ~0UL;
+      phase_ = Phase::Watch;
+    }
+    if (phase_ == Phase::Watch) {
+      for (uint8_t i = 0; i < count_; ++i) {
+        if ((rising & (1u << i)) && seqLen_ < kMaxSeq) seq_[seqLen_++] = i;
+      }
+      if (rising) ledOnMs_ = now;
+      if (falling && now - ledOnMs_ < shortestOnMs_) shortestOnMs_ = now - ledOnMs_;
+      // vio el patrón completo y ya se apagó
+      if (seqLen_ >= level_ && leds == 0) {
+        unsigned long at = now + cfg_.reactionMs;
+        uint32_t errorPermille = cfg_.errorPermille;
+        if (shortestOnMs_ < cfg_.perceptionMs) {
+          errorPermille += (cfg_.perceptionMs - shortestOnMs_) * 1000 / cfg_.perceptionMs;
+        }
+        for (uint8_t i = 0; i < seqLen_; ++i) {
+          uint8_t btn = seq_[i];
+          if (errorPermille && nextRand() % 1000 < errorPermille) {
+            btn = (uint8_t)((btn + 1) % count_);
+          }
+          queuePress(btn, at);
+        }
+        phase_ = Phase::Play;
+      }
+    }
+  } else if (strncmp(row, "Game Over", 9) == 0 || strncmp(row, "!GANASTE!", 9) == 0) {
+    if (phase_ != Phase::Finished) {
+      ++stats_.games;
+      if (row[0] == '!') ++stats_.wins;
+      stats_.levelSum += level_;
+      level_ = 0;
+      phase_ = Phase::Finished;
+      queueLen_ = queuePos_ = 0;
+      holding_ = false;
+      bouncePin_ = 0xFF;
+      for (uint8_t i = 0; i < count_; ++i) sim::setInput(buttonPins_[i], HIGH);
+      // un botón para volver a IDLE
+      queuePress(0, now + cfg_.reactionMs);
+    }
+  } else if (strncmp(row, "Presiona", 8) == 0) {
+    // la partida arranca kChordMs después de apretar: mientras tanto el
+    // LCD sigue igual y no hay que apretar de nuevo
+    bool starting = phase_ == Phase::Watch && level_ == 0 && now - levelStartMs_ < 1000;
+    if (phase_ != Phase::Idle && !busy && !starting) phase_ = Phase::Idle;
+    if (phase_ == Phase::Idle && !busy && gamesLeft_ > 0) {
+      --gamesLeft_;
+      phase_ = Phase::Watch;
+      level_ = 0;
+      levelStartMs_ = now;
+      queuePress(0, now + cfg_.reactionMs);
+    }
+  }
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+// Jugador sintético para el simulador.
+// Mira los LEDs y el LCD como lo haría una persona: cuenta los pasos que
+// muestra el patrón, espera su tiempo de reacción y los repite con los
+// botones. Con errorPermille se equivoca a propósito de vez en cuando.
+
+#include "Sim.h"
+
+class LiquidCrystal;
+
+struct PlayerConfig {
+  unsigned long reactionMs = 300;   // desde que termina el patrón
+  unsigned long holdMs = 80;        // cuánto mantiene presionado
+  unsigned long gapMs = 120;        // entre un botón y el siguiente
+  uint16_t errorPermille = 0;       // probabilidad de fallar cada paso
+  uint8_t bounceMs = 0;             // rebote del contacto al cambiar
+  // si un LED dura menos que esto, cada paso se le escapa con probabilidad
+  // proporcional a lo que faltó (0 = ve todo)
+  uint16_t perceptionMs = 0;
+  uint32_t seed = 1;
+};
+
+struct PlayerStats {
+  uint32_t games = 0;
+  uint32_t wins = 0;
+  uint32_t levelSum = 0;            // nivel alcanzado, sumado por juego
+  uint32_t rounds = 0;              // rondas completadas
+  uint64_t roundMsSum = 0;          // duración de esas rondas
+};
+
+class SyntheticPlayer {
+public:
+  SyntheticPlayer(const uint8_t* buttonPins, const uint8_t* ledPins,
+                  uint8_t count, const PlayerConfig& cfg);
+
+  // Cuántos juegos empezar; después se queda quieto en IDLE
+  void setGamesToPlay(uint32_t n) { gamesLeft_ = n; }
+
+  // El LCD que mira; por defecto el último que se creó en la placa (con
+  // varias estaciones hay uno por cada una)
+  void setLcd(const LiquidCrystal* lcd) { lcd_ = lcd; }
+
+  // Llamar una vez por pasada de loop()
+  void update();
+
+  bool done() const { return gamesLeft_ == 0 && phase_ == Phase::Idle; }
+  const PlayerStats& stats() const { return stats_; }
+
+private:
+  enum class Phase { Idle, Watch, Play, Finished };
+
+  static const uint8_t kMaxSeq = 64;
+
+  const uint8_t* buttonPins_;
+  const uint8_t* ledPins_;
+  uint8_t count_;
+  PlayerConfig cfg_;
+  PlayerStats stats_;
+  uint32_t gamesLeft_;
+  uint32_t rng_;
+  const LiquidCrystal* lcd_;
+
+  Phase phase_;
+  uint8_t level_;
+  unsigned long levelStartMs_;
+  uint8_t prevLeds_;
+  unsigned long ledOnMs_;           // cuándo se prendió el último LED
+  unsigned long shortestOnMs_;      // LED más corto de esta ronda
+  uint8_t seq_[kMaxSeq];
+  uint8_t seqLen_;
+
+  // botones pendientes de presionar
+  uint8_t queue_[kMaxSeq];
+  uint8_t queueLen_;
+  uint8_t queuePos_;
+  bool holding_;
+  unsigned long nextActionMs_;
+  uint8_t bouncePin_;
+  uint8_t bounceLevel_;             // nivel final después del rebote
+  unsigned long bounceUntilMs_;
+
+  uint8_t readLeds() const;
+  void queuePress(uint8_t btn, unsigned long atMs);
+  void runQueue(unsigned long now);
+  void press(uint8_t pin, uint8_t level, unsigned long now);
+  uint32_t nextRand();
+};
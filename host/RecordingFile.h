@@ -0,0 +1,69 @@
+#pragma once
+
+// Archivos de grabaciones para las herramientas del simulador: binario con
+// grabaciones una detrás de otra, o texto con líneas "REC <hex>" (lo que
+// sale por Serial de un Arduino compilado con SIMON_RECORD).
+
+#include "../GameRecorder.h"
+
+#include <stdio.h>
+#include <vector>
+
+struct RecordingSet {
+  std::vector<uint8_t> bytes;
+  std::vector<size_t> offsets;   // inicio de cada grabación en bytes
+
+  size_t count() const { return offsets.size(); }
+  const uint8_t* data(size_t i) const { return bytes.data() + offsets[i]; }
+  uint16_t size(size_t i) const {
+    size_t end = i + 1 < offsets.size() ? offsets[i + 1] : bytes.size();
+    return (uint16_t)(end - offsets[i]);
+  }
+
+  void add(const uint8_t* data, uint16_t len) {
+    offsets.push_back(bytes.size());
+    bytes.insert(bytes.end(), data, data + len);
+  }
+};
+
+// Largo de la grabación que empieza en data (0 si no es válida)
+inline uint16_t recordingLength(const uint8_t* data, size_t avail) {
+  if (avail < REC_HEADER || data[0] != 'S' || data[1] != 'R') return 0;
+  size_t len = REC_HEADER + (size_t)(data[8] | (data[9] << 8));
+  return len <= avail ? (uint16_t)len : 0;
+}
+
+// Agrega a set las grabaciones de path; devuelve cuántas leyó o -1
+inline long loadRecordings(const char* path, RecordingSet& set) {
+  FILE* f = fopen(path, "rb");
+  if (!f) return -1;
+  std::vector<uint8_t> raw;
+  uint8_t chunk[4096];
+  size_t n;
+  while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) {
+    raw.insert(raw.end(), chunk, chunk + n);
+  }
+  fclose(f);
+
+  long found = 0;
+  if (raw.size() >= 2 && raw[0] == 'S' && raw[1] == 'R') {
+    size_t pos = 0;
+    while (pos < raw.size()) {
+      uint16_t len = recordingLength(raw.data() + pos, raw.size() - pos);
+      if (!len) break;
+      set.add(raw.data() + pos, len);
+      pos += len;
+      ++found;
+    }
+  } else {
+    std::vector<uint8_t> buf(4096);
+    RecordingLineReader reader(buf.data(), (uint16_t)buf.size());
+    for (uint8_t c : raw) {
+      if (reader.feed((char)c)) {
+        set.add(reader.data(), reader.size());
+        ++found;
+      }
+    }
+  }
+  return found;
+}
@@ -0,0 +1,130 @@
+// Reproduce grabaciones de partidas a velocidad virtual y verifica que
+// terminen igual que cuando se grabaron (mismo resultado y puntaje).
+//
+//   simon_replay [-v] [--pass-us US] archivo...
+//
+// Los archivos pueden ser binarios (--record del simulador) o texto con
+// líneas "REC <hex>" copiadas del monitor serie.
+
+#include "Sim.h"
+#include "Station.h"
+#include "RecordingFile.h"
+
+#include <chrono>
+#include <stdlib.h>
+
+struct ReplayResult {
+  bool finished;
+  bool won;
+  int score;
+  uint64_t virtualUs;
+};
+
+static ReplayResult replayOne(const uint8_t* data, uint16_t len,
+                              unsigned long passUs, bool verbose) {
+  ReplayResult r = {false, false, 0, 0};
+  sim::reset();
+  Station st;
+  st.begin();
+
+  InputReplay replay;
+  if (!replay.load(data, len) || !st.game.startReplay(&replay)) return r;
+
+  State last = st.game.state();
+  bool started = false;
+  uint64_t startUs = sim::board().nowUs;
+  // la partida más larga posible no llega a 10 minutos virtuales
+  const uint64_t limitUs = startUs + 600000000ULL;
+  bool live = false;
+  while (sim::board().nowUs < limitUs) {
+    st.game.loop();
+    // la grabación se acabó sin llegar a GAME_OVER
+    if (!live && !st.game.replaying() && st.game.state() != State::GAME_OVER) {
+      live = true;
+      if (verbose) {
+        printf("  %8.1f ms  vuelven los botones reales\n",
+               (sim::board().nowUs - startUs) / 1000.0);
+      }
+    }
+    State s = st.game.state();
+    if (s != last) {
+      if (verbose) {
+        printf("  %8.1f ms  %s\n", (sim::board().nowUs - startUs) / 1000.0,
+               stateName(s));
+      }
+      if (s != State::IDLE) started = true;
+      last = s;
+      if (started && s == State::GAME_OVER) {
+        r.finished = true;
+        break;
+      }
+    }
+    sim::advance(passUs);
+  }
+
+  r.won = st.game.won();
+  r.score = st.game.score();
+  r.virtualUs = sim::board().nowUs - startUs;
+  if (verbose) {
+    printf("  patrón:");
+    for (uint8_t i = 0; i < st.pattern.length(); ++i) {
+      printf(" %u", st.pattern.getStep(i));
+    }
+    printf("\n");
+  }
+  return r;
+}
+
+int main(int argc, char** argv) {
+  bool verbose = false;
+  unsigned long passUs = 200;
+  RecordingSet set;
+
+  for (int i = 1; i < argc; ++i) {
+    if (!strcmp(argv[i], "-v")) {
+      verbose = true;
+    } else if (!strcmp(argv[i], "--pass-us") && i + 1 < argc) {
+      passUs = strtoul(argv[++i], nullptr, 10);
+    } else if (loadRecordings(argv[i], set) < 0) {
+      fprintf(stderr, "no se pudo leer %s\n", argv[i]);
+      return 2;
+    }
+  }
+  if (set.count() == 0) {
+    fprintf(stderr, "uso: simon_replay [-v] [--pass-us US] archivo...\n");
+    return 2;
+  }
+
+  size_t mismatches = 0, skipped = 0;
+  uint64_t virtualUs = 0;
+  auto t0 = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < set.count(); ++i) {
+    InputReplay header;
+    // cortada o de otra versión: no hay con qué comparar
+    if (!header.load(set.data(i), set.size(i))) {
+      ++skipped;
+      if (verbose) printf("partida %zu  no se puede reproducir\n", i);
+      continue;
+    }
+    if (verbose) {
+      printf("partida %zu  semilla %lu  grabada: %s %u\n", i,
+             (unsigned long)header.seed(), header.won() ? "ganó" : "perdió",
+             header.score());
+    }
+    ReplayResult r = replayOne(set.data(i), set.size(i), passUs, verbose);
+    virtualUs += r.virtualUs;
+    if (!r.finished || r.won != header.won() || r.score != header.score()) {
+      ++mismatches;
+      printf("partida %zu: DIFERENTE (grabada %s %u, reproducida %s %d%s)\n", i,
+             header.won() ? "ganó" : "perdió", header.score(),
+             r.won ? "ganó" : "perdió", r.score,
+             r.finished ? "" : ", no terminó");
+    }
+  }
+  double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+  printf("%zu partidas, %zu diferentes, %.0f partidas/s, %.0fx tiempo real\n",
+         set.count(), mismatches, set.count() / secs, virtualUs / 1e6 / secs);
+  if (skipped) printf("%zu sin reproducir (cortadas o de otra versión)\n", skipped);
+  return mismatches ? 1 : 0;
+}
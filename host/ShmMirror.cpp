@@ -0,0 +1,70 @@
+#include "ShmMirror.h"
+#include "LiquidCrystal.h"
+
+#include <fcntl.h>
+#include <new>
+#include <sys/mman.h>
+#include <unistd.h>
+
+static void publishHook(void* ctx) {
+  ((ShmMirror*)ctx)->publish();
+}
+
+bool ShmMirror::open(const char* name, const uint8_t* ledPins, uint8_t ledCount) {
+  close();
+  int fd = shm_open(name, O_CREAT | O_RDWR, 0644);
+  if (fd < 0) return false;
+  if (ftruncate(fd, sizeof(shm::Region)) != 0) {
+    ::close(fd);
+    return false;
+  }
+  void* p = mmap(nullptr, sizeof(shm::Region), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (p == MAP_FAILED) return false;
+
+  region_ = new (p) shm::Region;
+  region_->seq.store(0, std::memory_order_relaxed);
+  region_->version = shm::kVersion;
+  region_->magic = shm::kMagic;
+  strncpy(name_, name, sizeof(name_) - 1);
+  name_[sizeof(name_) - 1] = '\0';
+  ledPins_ = ledPins;
+  ledCount_ = ledCount;
+  memset(&snap_, 0, sizeof(snap_));
+  sim::board().onAdvance = publishHook;
+  sim::board().onAdvanceCtx = this;
+  publish();
+  return true;
+}
+
+void ShmMirror::close() {
+  if (!region_) return;
+  if (sim::board().onAdvanceCtx == this) sim::board().onAdvance = nullptr;
+  munmap(region_, sizeof(shm::Region));
+  shm_unlink(name_);
+  region_ = nullptr;
+}
+
+void ShmMirror::publish() {
+  if (!region_) return;
+  const sim::Board& b = sim::board();
+  snap_.nowUs = b.nowUs;
+  ++snap_.updates;
+  for (uint8_t i = 0; i < sizeof(snap_.pins); ++i) snap_.pins[i] = sim::pinLevel(i);
+  snap_.leds = 0;
+  for (uint8_t i = 0; i < ledCount_; ++i) {
+    if (sim::pinLevel(ledPins_[i]) == HIGH) snap_.leds |= (uint8_t)(1u << i);
+  }
+  snap_.buzzerHz = (uint16_t)sim::toneNow();
+  if (b.lcd) {
+    snap_.lcdOn = b.lcd->isOn();
+    snap_.lcdShift = b.lcd->shift();
+    snap_.lcdCols = b.lcd->cols();
+    for (uint8_t r = 0; r < 2; ++r) {
+      for (uint8_t c = 0; c < LiquidCrystal::kLineLen; ++c) {
+        snap_.lcd[r][c] = b.lcd->ddramAt(r, c);
+      }
+    }
+  }
+  shm::publish(region_, snap_);
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+// Copia el estado de la placa activa (pines, LEDs, buzzer y LCD) en una
+// región de memoria compartida (ver ShmState.h). Una vez abierta, cada
+// sim::advance() publica una foto nueva.
+
+#include "Sim.h"
+#include "ShmState.h"
+
+class ShmMirror {
+public:
+  ShmMirror() : region_(nullptr), ledPins_(nullptr), ledCount_(0) {}
+  ~ShmMirror() { close(); }
+
+  // name al estilo shm_open ("/simon"); ledPins para armar la máscara de LEDs
+  bool open(const char* name, const uint8_t* ledPins, uint8_t ledCount);
+  void close();
+
+  void publish();
+
+  uint64_t updates() const { return snap_.updates; }
+
+private:
+  shm::Region* region_;
+  const uint8_t* ledPins_;
+  uint8_t ledCount_;
+  char name_[64];
+  shm::Snapshot snap_;
+};
@@ -0,0 +1,63 @@
+#pragma once
+
+// Estado del simulador en memoria compartida POSIX, para visualizadores
+// externos que no quieren copiar cuadros por un pipe.
+//
+// El simulador es el único que escribe y lo protege con un seqlock: `seq`
+// queda impar mientras escribe y par cuando terminó. El lector copia todo y
+// se queda con la copia solo si leyó el mismo `seq` par antes y después.
+// Ninguno de los dos hace llamadas al sistema ni toma locks.
+
+#include <atomic>
+#include <stdint.h>
+#include <string.h>
+
+namespace shm {
+
+const uint32_t kMagic = 0x53494D4E;   // "SIMN"
+const uint32_t kVersion = 1;
+
+struct Snapshot {
+  uint64_t nowUs;           // reloj virtual
+  uint64_t updates;         // publicaciones desde que se abrió
+  uint8_t pins[20];         // nivel visible de cada pin
+  uint8_t leds;             // bit i = LED i encendido
+  uint8_t lcdOn;
+  uint8_t lcdShift;         // corrimiento de la ventana visible
+  uint8_t lcdCols;
+  uint16_t buzzerHz;        // 0 = silencio
+  char lcd[2][40];          // DDRAM completa del HD44780
+};
+
+struct Region {
+  uint32_t magic;
+  uint32_t version;
+  std::atomic<uint32_t> seq;
+  uint32_t pad;
+  Snapshot data;
+};
+
+// Lado del simulador
+inline void publish(Region* r, const Snapshot& s) {
+  uint32_t q = r->seq.load(std::memory_order_relaxed);
+  r->seq.store(q + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  memcpy(&r->data, &s, sizeof(Snapshot));
+  r->seq.store(q + 2, std::memory_order_release);
+}
+
+// Lado del lector; devuelve cuántos reintentos necesitó
+inline uint32_t read(const Region* r, Snapshot& out) {
+  uint32_t retries = 0;
+  for (;;) {
+    uint32_t a = r->seq.load(std::memory_order_acquire);
+    if (!(a & 1)) {
+      memcpy(&out, &r->data, sizeof(Snapshot));
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (r->seq.load(std::memory_order_relaxed) == a) return retries;
+    }
+    ++retries;
+  }
+}
+
+}  // namespace shm
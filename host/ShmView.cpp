@@ -0,0 +1,139 @@
+// Visualizador de ejemplo para la memoria compartida del simulador
+// (ProyectoEstructuras --shm /simon) y medición de la tasa de publicación.
+//
+//   simon_shm_view [--name /simon] [--count N]
+//   simon_shm_view --bench SEGUNDOS
+//
+// El modo normal lee una foto consistente 10 veces por segundo sin ninguna
+// llamada al sistema por lectura. --bench publica desde un hilo tan rápido
+// como puede mientras otro hilo lee por su propio mapeo, y cuenta fotos
+// inconsistentes (tienen que ser 0).
+
+#include "Sim.h"
+#include "LiquidCrystal.h"
+#include "ShmMirror.h"
+#include "../Pins.h"
+
+#include <atomic>
+#include <chrono>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <thread>
+#include <unistd.h>
+
+static const shm::Region* mapRegion(const char* name) {
+  int fd = shm_open(name, O_RDONLY, 0);
+  if (fd < 0) return nullptr;
+  void* p = mmap(nullptr, sizeof(shm::Region), PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (p == MAP_FAILED) return nullptr;
+  const shm::Region* r = (const shm::Region*)p;
+  if (r->magic != shm::kMagic || r->version != shm::kVersion) {
+    munmap(p, sizeof(shm::Region));
+    return nullptr;
+  }
+  return r;
+}
+
+static int view(const char* name, long count) {
+  const shm::Region* r = mapRegion(name);
+  if (!r) {
+    fprintf(stderr, "no hay simulador publicando en %s\n", name);
+    return 1;
+  }
+  shm::Snapshot s;
+  uint64_t lastUpdates = 0;
+  for (long i = 0; count < 0 || i < count; ++i) {
+    uint32_t retries = shm::read(r, s);
+    char rows[2][41];
+    for (uint8_t row = 0; row < 2; ++row) {
+      uint8_t cols = s.lcdCols ? s.lcdCols : 16;
+      for (uint8_t c = 0; c < cols; ++c) {
+        rows[row][c] = s.lcdOn ? s.lcd[row][(c + s.lcdShift) % 40] : ' ';
+      }
+      rows[row][cols] = '\0';
+    }
+    char leds[5];
+    for (uint8_t l = 0; l < 4; ++l) leds[l] = (s.leds >> l) & 1 ? '#' : '.';
+    leds[4] = '\0';
+    printf("%9.3f s  [%s] [%s]  leds %s  buzzer %5u Hz  %6llu pub  %u reint\n",
+           s.nowUs / 1e6, rows[0], rows[1], leds, s.buzzerHz,
+           (unsigned long long)(s.updates - lastUpdates), retries);
+    fflush(stdout);
+    lastUpdates = s.updates;
+    usleep(100000);
+  }
+  return 0;
+}
+
+static int bench(double seconds) {
+  char name[64];
+  snprintf(name, sizeof(name), "/simon_bench_%d", (int)getpid());
+
+  sim::reset();
+  LiquidCrystal lcd(A0, A1, A2, A3, A4, A5);
+  lcd.begin(16, 2);
+  lcd.print("bench");
+  ShmMirror mirror;
+  if (!mirror.open(name, LED_PINS, 4)) {
+    perror("shm_open");
+    return 1;
+  }
+  const shm::Region* r = mapRegion(name);
+  if (!r) return 1;
+
+  // cada publicación avanza 1 µs: en una foto consistente el reloj menos
+  // el contador de publicaciones da siempre lo mismo
+  const uint64_t invariant = sim::board().nowUs - mirror.updates();
+
+  std::atomic<bool> stop{false};
+  uint64_t reads = 0, torn = 0, retries = 0;
+  std::thread reader([&] {
+    shm::Snapshot s;
+    while (!stop.load(std::memory_order_relaxed)) {
+      retries += shm::read(r, s);
+      ++reads;
+      if (s.nowUs - s.updates != invariant) ++torn;
+    }
+  });
+
+  // el escritor corre en este hilo, con su placa
+  auto t0 = std::chrono::steady_clock::now();
+  auto until = t0 + std::chrono::duration<double>(seconds);
+  uint64_t published = 0;
+  while (std::chrono::steady_clock::now() < until) {
+    for (int i = 0; i < 1024; ++i) {
+      digitalWrite(LED_PINS[i & 3], (i >> 2) & 1);
+      sim::advance(1);
+    }
+    published += 1024;
+  }
+  double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  stop = true;
+  reader.join();
+
+  printf("publicaciones: %.2f M/s  lecturas: %.2f M/s  reintentos: %.1f%%  "
+         "fotos inconsistentes: %llu\n",
+         published / secs / 1e6, reads / secs / 1e6,
+         reads ? 100.0 * retries / (reads + retries) : 0.0,
+         (unsigned long long)torn);
+  munmap((void*)r, sizeof(shm::Region));
+  return torn ? 1 : 0;
+}
+
+int main(int argc, char** argv) {
+  const char* name = "/simon";
+  long count = -1;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    if (!strcmp(argv[i], "--name")) name = argv[i + 1];
+    else if (!strcmp(argv[i], "--count")) count = atol(argv[i + 1]);
+    else if (!strcmp(argv[i], "--bench")) return bench(atof(argv[i + 1]));
+    else {
+      fprintf(stderr, "opción desconocida: %s\n", argv[i]);
+      return 2;
+    }
+  }
+  return view(name, count);
+}
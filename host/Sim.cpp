@@ -0,0 +1,366 @@
+#include "Sim.h"
+#include "LiquidCrystal.h"
+#include "EEPROM.h"
+#include "avr/sleep.h"
+
+namespace sim {
+
+static Board defaultBoard_;
+static thread_local Board* current_ = &defaultBoard_;
+
+Board& board() { return *current_; }
+
+void use(Board* b) { current_ = b ? b : &defaultBoard_; }
+
+void reset(uint32_t analogNoise) {
+  Board& b = *current_;
+  b.nowUs = 0;
+  for (uint8_t i = 0; i < kPins; ++i) {
+    b.mode[i] = INPUT;
+    b.out[i] = LOW;
+    b.in[i] = HIGH;
+    b.analog[i] = (uint16_t)((analogNoise >> (i % 16)) & 0x3FF);
+  }
+  b.tonePin = 0xFF;
+  b.toneFreq = 0;
+  b.toneEndUs = 0;
+  b.randState = 1;
+  b.lcd = nullptr;
+  b.lcdFree = false;
+  b.serialRxHead = b.serialRxTail = 0;
+  b.serialTx = nullptr;
+  b.serialTxCtx = nullptr;
+  b.onTone = nullptr;
+  b.onToneCtx = nullptr;
+  b.onPin = nullptr;
+  b.onPinCtx = nullptr;
+  b.onAdvance = nullptr;
+  b.onAdvanceCtx = nullptr;
+  b.onInterval = nullptr;
+  b.onIntervalCtx = nullptr;
+  b.asleep = false;
+}
+
+void advance(unsigned long us) {
+  Board& b = *current_;
+  if (b.onInterval) b.onInterval(us, b.onIntervalCtx);
+  b.asleep = false;
+  uint64_t target = b.nowUs + us;
+  // EE_READY interrumpe apenas la EEPROM queda libre, aunque sea en medio
+  // de un delay(): corre con el reloj en ese instante
+  Eeprom& e = b.eeprom;
+  while (e.readyIrq && e.readyIsr) {
+    uint64_t at = e.busyUntilUs > b.nowUs ? e.busyUntilUs : b.nowUs;
+    if (at > target) break;
+    b.nowUs = at;
+    e.readyIsr();
+    if (e.busyUntilUs <= at) break;   // no arrancó otra grabación
+  }
+  b.nowUs = target;
+  if (b.onAdvance) b.onAdvance(b.onAdvanceCtx);
+}
+
+void setInput(uint8_t pin, uint8_t level) {
+  if (pin < kPins) current_->in[pin] = level;
+}
+
+uint8_t pinLevel(uint8_t pin) {
+  if (pin >= kPins) return LOW;
+  return current_->mode[pin] == OUTPUT ? current_->out[pin] : current_->in[pin];
+}
+
+size_t serialInput(const uint8_t* data, size_t len) {
+  Board& b = *current_;
+  size_t n = 0;
+  while (n < len) {
+    uint16_t next = (uint16_t)((b.serialRxHead + 1) % kSerialRxSize);
+    if (next == b.serialRxTail) break;
+    b.serialRx[b.serialRxHead] = data[n++];
+    b.serialRxHead = next;
+  }
+  return n;
+}
+
+unsigned int toneNow() {
+  Board& b = *current_;
+  if (b.toneFreq && b.toneEndUs && b.nowUs >= b.toneEndUs) b.toneFreq = 0;
+  return b.toneFreq;
+}
+
+}  // namespace sim
+
+// API de Arduino
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  if (pin < sim::kPins) sim::board().mode[pin] = mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+  if (pin >= sim::kPins) return;
+  sim::Board& b = sim::board();
+  uint8_t level = val ? HIGH : LOW;
+  if (b.out[pin] == level) return;
+  b.out[pin] = level;
+  if (b.onPin) b.onPin(pin, level, b.onPinCtx);
+}
+
+int digitalRead(uint8_t pin) {
+  return sim::pinLevel(pin);
+}
+
+int analogRead(uint8_t pin) {
+  // analogRead(0) es el canal A0
+  if (pin < A0) pin += A0;
+  return pin < sim::kPins ? sim::board().analog[pin] : 0;
+}
+
+unsigned long millis() {
+  return (unsigned long)((sim::board().nowUs / 1000) & 0xFFFFFFFFUL);
+}
+
+unsigned long micros() {
+  return (unsigned long)(sim::board().nowUs & 0xFFFFFFFFUL);
+}
+
+void delay(unsigned long ms) {
+  sim::advance(ms * 1000UL);
+}
+
+void delayMicroseconds(unsigned int us) {
+  sim::advance(us);
+}
+
+void tone(uint8_t pin, unsigned int frequency, unsigned long duration) {
+  sim::Board& b = sim::board();
+  b.tonePin = pin;
+  b.toneFreq = frequency;
+  b.toneEndUs = duration ? b.nowUs + duration * 1000UL : 0;
+  if (b.onTone) b.onTone(frequency, b.toneEndUs, b.onToneCtx);
+}
+
+void noTone(uint8_t pin) {
+  sim::Board& b = sim::board();
+  if (b.tonePin != pin) return;
+  b.toneFreq = 0;
+  if (b.onTone) b.onTone(0, 0, b.onToneCtx);
+}
+
+// Solo lo anota: despierta en el próximo advance()
+void sleep_mode() {
+  sim::board().asleep = true;
+}
+
+// Park-Miller "minimal standard", igual que avr-libc
+long random(long howbig) {
+  if (howbig == 0) return 0;
+  uint32_t& ctx = sim::board().randState;
+  long x = (long)ctx;
+  if (x == 0) x = 123459876L;
+  long hi = x / 127773L;
+  long lo = x % 127773L;
+  x = 16807L * lo - 2836L * hi;
+  if (x < 0) x += 0x7FFFFFFFL;
+  ctx = (uint32_t)x;
+  return (long)((unsigned long)x % 0x80000000UL) % howbig;
+}
+
+long random(long howsmall, long howbig) {
+  if (howsmall >= howbig) return howsmall;
+  return random(howbig - howsmall) + howsmall;
+}
+
+void randomSeed(unsigned long seed) {
+  if (seed != 0) sim::board().randState = (uint32_t)seed;
+}
+
+// Serial
+
+HardwareSerial Serial;
+
+void HardwareSerial::begin(unsigned long) {}
+
+int HardwareSerial::available() {
+  sim::Board& b = sim::board();
+  return (b.serialRxHead + sim::kSerialRxSize - b.serialRxTail) % sim::kSerialRxSize;
+}
+
+int HardwareSerial::peek() {
+  sim::Board& b = sim::board();
+  if (b.serialRxHead == b.serialRxTail) return -1;
+  return b.serialRx[b.serialRxTail];
+}
+
+int HardwareSerial::read() {
+  sim::Board& b = sim::board();
+  if (b.serialRxHead == b.serialRxTail) return -1;
+  uint8_t c = b.serialRx[b.serialRxTail];
+  b.serialRxTail = (uint16_t)((b.serialRxTail + 1) % sim::kSerialRxSize);
+  return c;
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+  sim::Board& b = sim::board();
+  if (b.serialTx) b.serialTx(c, b.serialTxCtx);
+  return 1;
+}
+
+// EEPROM: como eeprom_write_byte() de avr-libc, una escritura arranca la
+// grabación y vuelve; la próxima lectura o escritura espera a que termine
+
+EEPROMClass EEPROM;
+
+static void eepromWait(sim::Eeprom& e) {
+  uint64_t now = sim::board().nowUs;
+  if (e.busyUntilUs > now) sim::advance((unsigned long)(e.busyUntilUs - now));
+}
+
+uint8_t EEPROMClass::read(int idx) {
+  sim::Eeprom& e = sim::board().eeprom;
+  if (idx < 0 || idx >= (int)sim::kEepromSize) return 0xFF;
+  eepromWait(e);
+  return e.data[idx];
+}
+
+void EEPROMClass::write(int idx, uint8_t val) {
+  sim::Eeprom& e = sim::board().eeprom;
+  if (idx < 0 || idx >= (int)sim::kEepromSize) return;
+  eepromWait(e);
+  e.data[idx] = val;
+  e.busyUntilUs = sim::board().nowUs + sim::kEepromWriteUs;
+  ++e.writes;
+}
+
+void EEPROMClass::update(int idx, uint8_t val) {
+  if (read(idx) != val) write(idx, val);
+}
+
+uint16_t EEPROMClass::length() {
+  return sim::kEepromSize;
+}
+
+uint8_t eepromReadNow(uint16_t addr) {
+  sim::Eeprom& e = sim::board().eeprom;
+  return addr < sim::kEepromSize ? e.data[addr] : 0xFF;
+}
+
+void eepromStartWrite(uint16_t addr, uint8_t value) {
+  sim::Eeprom& e = sim::board().eeprom;
+  uint64_t now = sim::board().nowUs;
+  if (addr >= sim::kEepromSize || e.busyUntilUs > now) return;
+  e.data[addr] = value;
+  e.busyUntilUs = now + sim::kEepromWriteUs;
+  ++e.writes;
+}
+
+void eepromWaitIdle() {
+  eepromWait(sim::board().eeprom);
+}
+
+void eepromReadyInterrupt(bool on) {
+  sim::board().eeprom.readyIrq = on;
+}
+
+void eepromSetReadyIsr(void (*isr)()) {
+  sim::board().eeprom.readyIsr = isr;
+}
+
+// LiquidCrystal
+
+LiquidCrystal::LiquidCrystal(uint8_t, uint8_t, uint8_t, uint8_t, uint8_t, uint8_t)
+  : cols_(16), rows_(2), addrRow_(0), addrCol_(0), shift_(0),
+    on_(false), transfers_(0) {
+  memset(ddram_, ' ', sizeof(ddram_));
+}
+
+void LiquidCrystal::transfer(unsigned long extraUs) {
+  ++transfers_;
+  if (!sim::board().lcdFree) sim::advance(sim::kLcdByteUs + extraUs);
+}
+
+void LiquidCrystal::begin(uint8_t cols, uint8_t rows) {
+  cols_ = cols;
+  rows_ = rows > kLines ? kLines : rows;
+  on_ = true;
+  transfers_ = 0;
+  sim::board().lcd = this;
+  // secuencia de inicio de la librería: ~50 ms de espera + 4 comandos
+  if (!sim::board().lcdFree) sim::advance(50000UL);
+  for (uint8_t i = 0; i < 4; ++i) transfer(0);
+  clear();
+}
+
+void LiquidCrystal::clear() {
+  memset(ddram_, ' ', sizeof(ddram_));
+  addrRow_ = addrCol_ = 0;
+  shift_ = 0;
+  transfer(sim::kLcdClearUs);
+}
+
+void LiquidCrystal::home() {
+  addrRow_ = addrCol_ = 0;
+  shift_ = 0;
+  transfer(sim::kLcdClearUs);
+}
+
+void LiquidCrystal::setCursor(uint8_t col, uint8_t row) {
+  if (row >= rows_) row = rows_ - 1;
+  addrRow_ = row;
+  addrCol_ = col % kLineLen;
+  transfer(0);
+}
+
+void LiquidCrystal::scrollDisplayLeft() {
+  shift_ = (uint8_t)((shift_ + 1) % kLineLen);
+  transfer(0);
+}
+
+void LiquidCrystal::scrollDisplayRight() {
+  shift_ = (uint8_t)((shift_ + kLineLen - 1) % kLineLen);
+  transfer(0);
+}
+
+void LiquidCrystal::display() {
+  on_ = true;
+  transfer(0);
+}
+
+void LiquidCrystal::noDisplay() {
+  on_ = false;
+  transfer(0);
+}
+
+void LiquidCrystal::command(uint8_t value) {
+  if (value == 0x01) {
+    clear();
+  } else if ((value & 0xFE) == 0x02) {
+    home();
+  } else if ((value & 0xF0) == 0x10 && (value & 0x08)) {
+    // corrimiento de pantalla: bit 2 = derecha
+    if (value & 0x04) scrollDisplayRight(); else scrollDisplayLeft();
+  } else if ((value & 0x80)) {
+    uint8_t addr = value & 0x7F;
+    addrRow_ = addr >= 0x40 ? 1 : 0;
+    addrCol_ = (uint8_t)((addr & 0x3F) % kLineLen);
+    transfer(0);
+  } else {
+    transfer(0);
+  }
+}
+
+size_t LiquidCrystal::write(uint8_t c) {
+  ddram_[addrRow_][addrCol_] = (char)c;
+  // como el HD44780: al final de una línea sigue en la otra
+  if (++addrCol_ >= kLineLen) {
+    addrCol_ = 0;
+    addrRow_ = (uint8_t)((addrRow_ + 1) % kLines);
+  }
+  transfer(0);
+  return 1;
+}
+
+void LiquidCrystal::visibleRow(uint8_t row, char* out) const {
+  for (uint8_t c = 0; c < cols_; ++c) {
+    out[c] = on_ ? ddram_[row][(c + shift_) % kLineLen] : ' ';
+  }
+  out[cols_] = '\0';
+}
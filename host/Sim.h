@@ -0,0 +1,98 @@
+#pragma once
+
+// Placa simulada: estado de pines, reloj virtual, tono y generador aleatorio.
+// Las funciones de Arduino.h leen y escriben sobre sim::board().
+
+#include "Arduino.h"
+
+class LiquidCrystal;
+
+namespace sim {
+
+// los de una Mega (el Uno usa los primeros 20); A0 sigue siendo 14, como
+// en el Uno
+const uint8_t kPins = 70;
+
+// Costo aproximado de una transferencia al LCD en modo de 4 bits (µs)
+const unsigned long kLcdByteUs = 210;
+const unsigned long kLcdClearUs = 2000;
+
+const uint16_t kSerialRxSize = 256;
+
+// EEPROM del ATmega328P: 1 KB, cada byte tarda ~3.3 ms en grabarse
+const uint16_t kEepromSize = 1024;
+const unsigned long kEepromWriteUs = 3300;
+
+// Sale de fábrica borrada (0xFF) y no la toca reset(): es lo único que
+// sobrevive a un apagado
+struct Eeprom {
+  uint8_t data[kEepromSize];
+  uint64_t busyUntilUs = 0;    // fin de la grabación en curso
+  uint32_t writes = 0;         // bytes grabados (desgaste)
+  bool readyIrq = false;       // EERIE
+  void (*readyIsr)() = nullptr;
+  Eeprom() { memset(data, 0xFF, sizeof(data)); }
+};
+
+struct Board {
+  uint64_t nowUs;
+  uint8_t mode[kPins];
+  uint8_t out[kPins];      // nivel que escribe el sketch
+  uint8_t in[kPins];       // nivel que imponen los botones externos
+  uint16_t analog[kPins];  // lecturas de analogRead()
+  uint8_t tonePin;
+  unsigned int toneFreq;   // 0 = en silencio
+  uint64_t toneEndUs;      // 0 = sin duración
+  uint32_t randState;
+  LiquidCrystal* lcd;      // el último LCD que hizo begin()
+  bool lcdFree;            // las transferencias al LCD no gastan tiempo
+  uint8_t serialRx[kSerialRxSize];
+  uint16_t serialRxHead;
+  uint16_t serialRxTail;
+  // destino de Serial.write(); nullptr = se descarta
+  void (*serialTx)(uint8_t c, void* ctx);
+  void* serialTxCtx;
+  // aviso de tone()/noTone(): frecuencia (0 = silencio) y fin (0 = sin fin)
+  void (*onTone)(unsigned int freq, uint64_t endUs, void* ctx);
+  void* onToneCtx;
+  // aviso de digitalWrite() que cambia el nivel de un pin
+  void (*onPin)(uint8_t pin, uint8_t level, void* ctx);
+  void* onPinCtx;
+  // se llama después de cada advance() (p. ej. para publicar el estado)
+  void (*onAdvance)(void* ctx);
+  void* onAdvanceCtx;
+  // se llama al principio de cada advance(), con la placa como queda
+  // durante esos us (p. ej. para integrar el consumo, Energy.h)
+  void (*onInterval)(unsigned long us, void* ctx);
+  void* onIntervalCtx;
+  // el sketch llamó a sleep_mode() (host/avr/sleep.h): el próximo
+  // advance() es tiempo dormido
+  bool asleep;
+  Eeprom eeprom;
+};
+
+// Placa activa en este hilo. Cada hilo arranca con una placa por defecto;
+// las herramientas que corren varias simulaciones en paralelo le dan a cada
+// hilo la suya con use().
+Board& board();
+void use(Board* b);
+
+// Deja la placa activa como recién encendida
+void reset(uint32_t analogNoise = 0);
+
+// Avanza el reloj virtual (el costo de una pasada de loop(), un delay, ...)
+void advance(unsigned long us);
+
+// Botón externo: LOW = presionado (los botones van a GND)
+void setInput(uint8_t pin, uint8_t level);
+
+// Nivel que se ve en el pin (salida si es OUTPUT, entrada si no)
+uint8_t pinLevel(uint8_t pin);
+
+// Bytes que le llegan al sketch por Serial; devuelve cuántos entraron
+size_t serialInput(const uint8_t* data, size_t len);
+
+// Frecuencia sonando ahora en el buzzer (0 = silencio)
+unsigned int toneNow();
+
+}  // namespace sim
@@ -0,0 +1,40 @@
+#pragma once
+
+// Una estación completa (periféricos + GameController) para las herramientas
+// del simulador que necesitan varias partidas independientes. Usa los mismos
+// pines que el sketch. Mode es la variante del juego y Periph los tipos de
+// los periféricos (ver Simon.h).
+
+#include "Sim.h"
+#include "../Pins.h"
+#include "../Simon.h"
+
+template <typename Mode, typename Periph = ArduinoPeripherals>
+struct BasicStation {
+  LiquidCrystal               lcd;
+  typename Periph::Leds       leds;
+  typename Periph::Buttons    buttons;
+  typename Periph::Sound      buzzer;
+  typename Periph::Display    display;
+  typename Periph::Pattern    pattern;
+  BasicGameController<Mode, Periph> game;
+
+  explicit BasicStation(uint16_t debounceMs = 25)
+    : lcd(A0, A1, A2, A3, A4, A5),
+      leds(LED_PINS, 4),
+      buttons(BUTTON_PINS, 4, debounceMs),
+      buzzer(BUZZER_PIN),
+      display(lcd),
+      pattern(4, 50),
+      game(pattern, leds, buttons, buzzer, display) {}
+
+  // Igual que setup() del sketch
+  void begin() {
+    leds.begin();
+    buttons.begin();
+    buzzer.begin();
+    game.begin();
+  }
+};
+
+typedef BasicStation<SIMON_MODE> Station;
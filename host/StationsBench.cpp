@@ -0,0 +1,194 @@
+// Varias estaciones en un MCU (Stations.h) en el simulador: 1, 2 y 3
+// estaciones sobre la misma placa, con el Scheduler, el ToneEngine y la
+// cola de la EEPROM compartidos y un jugador sintético por estación. Para
+// cada cantidad informa:
+//
+//   PC        ns de la PC por pasada de loop(), en total y por estación
+//   placa     µs virtuales por pasada de cada estación (StationStats): lo
+//             que cuesta en la placa, casi todo bus del LCD (LcdBuffer.h)
+//   voces     notas tocadas y descartadas de cada Voice
+//
+// Una nota o un click descartado es un error (ToneEngine.h): termina con
+// 1.
+//
+// Si el costo por estación no cambia con la cantidad, el loop crece
+// lineal. Con --sketch corre además setup()/loop() de stations.cpp (tres
+// estaciones) hasta que cada jugador termina sus partidas.
+//
+//   simon_stations_bench [--games N] [--errors PM] [--seed S] [--sketch]
+
+#include "Sim.h"
+#include "Player.h"
+#include "../Stations.h"
+
+#include <chrono>
+#include <memory>
+#include <stdio.h>
+#include <stdlib.h>
+
+void setup();
+void loop();
+extern GameStation* stations[SIMON_STATIONS];
+
+static EepromQueue benchQueue;
+
+static void benchEeReady() {
+  benchQueue.service();
+}
+
+struct Options {
+  uint32_t games = 20;
+  PlayerConfig player;
+  bool sketch = false;
+};
+
+struct Result {
+  uint64_t passes = 0;
+  double hostNs = 0;        // por pasada
+  double virtUs[3] = {0};   // por pasada de cada estación
+  uint16_t maxUs[3] = {0};
+  uint32_t games[3] = {0};
+  uint32_t played[3] = {0};
+  uint32_t dropped[3] = {0};
+};
+
+static void playersFor(uint8_t n, const Options& opt,
+                       std::unique_ptr<SyntheticPlayer> (&players)[3],
+                       LiquidCrystal* const* lcds) {
+  for (uint8_t i = 0; i < n; ++i) {
+    PlayerConfig cfg = opt.player;
+    cfg.seed = opt.player.seed + i;
+    players[i].reset(new SyntheticPlayer(STATION_PINS[i].buttons, STATION_PINS[i].leds, 4, cfg));
+    players[i]->setGamesToPlay(opt.games);
+    players[i]->setLcd(lcds[i]);
+  }
+}
+
+static bool allDone(uint8_t n, const std::unique_ptr<SyntheticPlayer> (&players)[3]) {
+  for (uint8_t i = 0; i < n; ++i) {
+    if (!players[i]->done()) return false;
+  }
+  return true;
+}
+
+// false si alguna voz descartó algo
+static bool printVoices(uint8_t n, const uint32_t* played, const uint32_t* dropped) {
+  bool ok = true;
+  printf("           voces:");
+  for (uint8_t i = 0; i < n; ++i) {
+    printf("  %u) %u tocadas %u descartadas", i, played[i], dropped[i]);
+    if (dropped[i]) ok = false;
+  }
+  printf("\n");
+  if (!ok) fprintf(stderr, "error: se descartaron notas\n");
+  return ok;
+}
+
+static Result run(uint8_t n, const Options& opt) {
+  typedef std::chrono::steady_clock HostClock;
+  sim::reset(opt.player.seed);
+  eepromSetReadyIsr(benchEeReady);
+  Scheduler sched;
+  ToneEngine audio;
+  std::unique_ptr<GameStation> st[3];
+  LiquidCrystal* lcds[3];
+  Result r;
+  for (uint8_t i = 0; i < n; ++i) {
+    st[i].reset(new GameStation(STATION_PINS[i], sched));
+    st[i]->begin(i, audio);
+    lcds[i] = &st[i]->lcd;
+  }
+  std::unique_ptr<SyntheticPlayer> players[3];
+  playersFor(n, opt, players, lcds);
+
+  HostClock::time_point t0 = HostClock::now();
+  while (!allDone(n, players)) {
+    for (uint8_t i = 0; i < n; ++i) players[i]->update();
+    Instant now = Clock::now();
+    for (uint8_t i = 0; i < n; ++i) st[i]->loop(now, benchQueue);
+    sched.run(now);
+    audio.update(now);
+    sim::advance(200);
+    ++r.passes;
+  }
+  r.hostNs = std::chrono::duration<double, std::nano>(HostClock::now() - t0).count() / r.passes;
+  for (uint8_t i = 0; i < n; ++i) {
+    const StationStats& s = st[i]->stats();
+    r.virtUs[i] = (double)s.busyUs / s.passes;
+    r.maxUs[i] = s.maxUs;
+    r.games[i] = players[i]->stats().games;
+    r.played[i] = st[i]->voice.played();
+    r.dropped[i] = st[i]->voice.dropped();
+  }
+  eepromSetReadyIsr(nullptr);
+  return r;
+}
+
+// setup()/loop() de stations.cpp, tal cual
+static int runSketch(const Options& opt) {
+  sim::reset(opt.player.seed);
+  setup();
+  LiquidCrystal* lcds[3];
+  for (uint8_t i = 0; i < SIMON_STATIONS; ++i) lcds[i] = &stations[i]->lcd;
+  std::unique_ptr<SyntheticPlayer> players[3];
+  playersFor(SIMON_STATIONS, opt, players, lcds);
+  uint64_t passes = 0;
+  while (!allDone(SIMON_STATIONS, players)) {
+    for (uint8_t i = 0; i < SIMON_STATIONS; ++i) players[i]->update();
+    loop();
+    sim::advance(200);
+    ++passes;
+  }
+  printf("sketch     %llu pasadas, %.1f s virtuales, partidas:",
+         (unsigned long long)passes, sim::board().nowUs / 1e6);
+  for (uint8_t i = 0; i < SIMON_STATIONS; ++i) printf(" %u", players[i]->stats().games);
+  printf("\n");
+  uint32_t played[3], dropped[3];
+  for (uint8_t i = 0; i < SIMON_STATIONS; ++i) {
+    played[i] = stations[i]->voice.played();
+    dropped[i] = stations[i]->voice.dropped();
+  }
+  return printVoices(SIMON_STATIONS, played, dropped) ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+  Options opt;
+  opt.player.errorPermille = 30;
+  for (int i = 1; i < argc; ++i) {
+    if (!strcmp(argv[i], "--sketch")) {
+      opt.sketch = true;
+      continue;
+    }
+    if (i + 1 >= argc) {
+      fprintf(stderr, "falta el valor de %s\n", argv[i]);
+      return 2;
+    }
+    const char* v = argv[++i];
+    if (!strcmp(argv[i - 1], "--games")) opt.games = (uint32_t)strtoul(v, nullptr, 10);
+    else if (!strcmp(argv[i - 1], "--errors")) opt.player.errorPermille = (uint16_t)atoi(v);
+    else if (!strcmp(argv[i - 1], "--seed")) opt.player.seed = (uint32_t)strtoul(v, nullptr, 10);
+    else {
+      fprintf(stderr, "opción desconocida: %s\n", argv[i - 1]);
+      return 2;
+    }
+  }
+
+  double base = 0;
+  bool ok = true;
+  for (uint8_t n = 1; n <= 3; ++n) {
+    printf(n == 1 ? "%u estación\n" : "%u estaciones\n", n);
+    Result r = run(n, opt);
+    double perStation = r.hostNs / n;
+    if (n == 1) base = perStation;
+    printf("           %llu pasadas, PC %.0f ns/pasada (%.0f por estación, x%.2f)\n",
+           (unsigned long long)r.passes, r.hostNs, perStation, perStation / base);
+    printf("           placa:");
+    for (uint8_t i = 0; i < n; ++i) {
+      printf("  %u) %.1f µs/pasada (máx %u) %u partidas", i, r.virtUs[i], r.maxUs[i], r.games[i]);
+    }
+    printf("\n");
+    if (!printVoices(n, r.played, r.dropped)) ok = false;
+  }
+  if (opt.sketch && runSketch(opt) != 0) ok = false;
+  return ok ? 0 : 1;
+}
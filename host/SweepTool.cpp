@@ -0,0 +1,224 @@
+// Barrido de parámetros: antirrebote, tiempos del patrón y tiempo límite de
+// respuesta, contra jugadores sintéticos o un corpus de partidas grabadas.
+// La grilla se reparte entre hilos; cada hilo tiene su propia placa y su
+// estación, creadas una sola vez y reiniciadas en cada partida.
+//
+//   simon_sweep [--debounce 5:40:5] [--on 400] [--off 200] [--timeout 0]
+//               [--games N] [--threads T] [--error PERMILLE]
+//               [--bounce MS] [--corpus partidas.bin]
+//               [--csv salida.csv] [--bin salida.bin]
+//
+// Cada eje acepta "a:b:paso" o una lista "a,b,c". Con --corpus se reproducen
+// las grabaciones en lugar de jugar: sirve para el antirrebote y el tiempo
+// límite, pero no para los tiempos del patrón (las respuestas grabadas
+// quedan desfasadas).
+
+#include "Sim.h"
+#include "Station.h"
+#include "Player.h"
+#include "RecordingFile.h"
+
+#include <atomic>
+#include <chrono>
+#include <stdlib.h>
+#include <thread>
+#include <vector>
+
+struct SweepPoint {
+  uint16_t debounceMs;
+  GameTiming timing;
+};
+
+// Una fila de resultados (también el registro del archivo binario)
+struct SweepResult {
+  uint16_t debounceMs;
+  uint16_t onMs;
+  uint16_t offMs;
+  uint16_t timeoutMs;
+  uint32_t games;
+  uint32_t wins;
+  uint32_t rounds;        // rondas completadas
+  uint32_t levelSum;
+  uint64_t roundMsSum;
+};
+
+struct SweepConfig {
+  uint32_t games = 200;
+  PlayerConfig player;
+  const RecordingSet* corpus = nullptr;
+  unsigned long passUs = 200;
+};
+
+static bool parseAxis(const char* text, std::vector<uint16_t>& out) {
+  out.clear();
+  unsigned a, b, step;
+  if (sscanf(text, "%u:%u:%u", &a, &b, &step) == 3 && step > 0 && a <= b) {
+    for (unsigned v = a; v <= b; v += step) out.push_back((uint16_t)v);
+    return true;
+  }
+  const char* p = text;
+  while (*p) {
+    char* end;
+    unsigned long v = strtoul(p, &end, 10);
+    if (end == p) return false;
+    out.push_back((uint16_t)v);
+    p = *end == ',' ? end + 1 : end;
+  }
+  return !out.empty();
+}
+
+// Corre una partida en la estación del hilo y acumula en res
+static void playOne(Station& st, const SweepConfig& cfg, uint32_t game,
+                    SweepResult& res) {
+  sim::reset(game * 2654435761u + 1);
+  st.begin();
+
+  PlayerConfig pc = cfg.player;
+  pc.seed = game + 1;   // mismos jugadores en cada punto de la grilla
+  SyntheticPlayer player(BUTTON_PINS, LED_PINS, 4, pc);
+  InputReplay replay;
+  bool replaying = false;
+  if (cfg.corpus) {
+    size_t i = game % cfg.corpus->count();
+    replaying = replay.load(cfg.corpus->data(i), cfg.corpus->size(i)) &&
+                st.game.startReplay(&replay);
+    if (!replaying) return;
+  } else {
+    player.setGamesToPlay(1);
+  }
+
+  State last = st.game.state();
+  uint64_t roundStartUs = 0;
+  const uint64_t limitUs = sim::board().nowUs + 600000000ULL;
+  while (sim::board().nowUs < limitUs) {
+    st.game.loop();
+    if (!replaying) player.update();
+    State s = st.game.state();
+    if (s != last) {
+      uint64_t now = sim::board().nowUs;
+      if (s == State::SHOW_PATTERN) {
+        if (last == State::WAIT_INPUT) {
+          ++res.rounds;
+          res.roundMsSum += (now - roundStartUs) / 1000;
+        }
+        roundStartUs = now;
+      } else if (s == State::GAME_OVER) {
+        if (st.game.won()) {
+          ++res.rounds;
+          res.roundMsSum += (now - roundStartUs) / 1000;
+        }
+        break;
+      }
+      last = s;
+    }
+    sim::advance(cfg.passUs);
+  }
+  ++res.games;
+  if (st.game.won()) ++res.wins;
+  res.levelSum += st.game.level();
+}
+
+static void worker(const std::vector<SweepPoint>& grid, const SweepConfig& cfg,
+                   std::vector<SweepResult>& results, std::atomic<size_t>& next) {
+  sim::Board board;
+  sim::use(&board);
+  Station st;
+
+  size_t idx;
+  while ((idx = next.fetch_add(1)) < grid.size()) {
+    const SweepPoint& p = grid[idx];
+    SweepResult& res = results[idx];
+    res = SweepResult{};
+    res.debounceMs = p.debounceMs;
+    res.onMs = p.timing.onMs;
+    res.offMs = p.timing.offMs;
+    res.timeoutMs = p.timing.inputTimeoutMs;
+    st.buttons.setDebounce(p.debounceMs);
+    st.game.setTiming(p.timing);
+    for (uint32_t g = 0; g < cfg.games; ++g) playOne(st, cfg, g, res);
+  }
+  sim::use(nullptr);
+}
+
+int main(int argc, char** argv) {
+  std::vector<uint16_t> debounce = {25}, on = {DEFAULT_TIMING.onMs},
+                        off = {DEFAULT_TIMING.offMs}, timeout = {0};
+  SweepConfig cfg;
+  unsigned threads = std::thread::hardware_concurrency();
+  const char* csvPath = nullptr;
+  const char* binPath = nullptr;
+  RecordingSet corpus;
+
+  for (int i = 1; i + 1 < argc; i += 2) {
+    const char* key = argv[i];
+    const char* val = argv[i + 1];
+    bool ok = true;
+    if (!strcmp(key, "--debounce")) ok = parseAxis(val, debounce);
+    else if (!strcmp(key, "--on")) ok = parseAxis(val, on);
+    else if (!strcmp(key, "--off")) ok = parseAxis(val, off);
+    else if (!strcmp(key, "--timeout")) ok = parseAxis(val, timeout);
+    else if (!strcmp(key, "--games")) cfg.games = (uint32_t)strtoul(val, nullptr, 10);
+    else if (!strcmp(key, "--threads")) threads = (unsigned)atoi(val);
+    else if (!strcmp(key, "--error")) cfg.player.errorPermille = (uint16_t)atoi(val);
+    else if (!strcmp(key, "--bounce")) cfg.player.bounceMs = (uint8_t)atoi(val);
+    else if (!strcmp(key, "--csv")) csvPath = val;
+    else if (!strcmp(key, "--bin")) binPath = val;
+    else if (!strcmp(key, "--corpus")) ok = loadRecordings(val, corpus) > 0;
+    else ok = false;
+    if (!ok) {
+      fprintf(stderr, "opción inválida: %s %s\n", key, val);
+      return 2;
+    }
+  }
+  if (corpus.count()) cfg.corpus = &corpus;
+  if (threads == 0) threads = 1;
+
+  std::vector<SweepPoint> grid;
+  for (uint16_t d : debounce)
+    for (uint16_t a : on)
+      for (uint16_t b : off)
+        for (uint16_t t : timeout)
+          grid.push_back(SweepPoint{d, GameTiming{a, b, t}});
+
+  std::vector<SweepResult> results(grid.size());
+  std::atomic<size_t> next{0};
+  auto t0 = std::chrono::steady_clock::now();
+  std::vector<std::thread> pool;
+  for (unsigned i = 0; i < threads && i < grid.size(); ++i) {
+    pool.emplace_back(worker, std::cref(grid), std::cref(cfg),
+                      std::ref(results), std::ref(next));
+  }
+  for (std::thread& t : pool) t.join();
+  double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+  FILE* csv = csvPath ? fopen(csvPath, "w") : stdout;
+  if (!csv) {
+    fprintf(stderr, "no se pudo crear %s\n", csvPath);
+    return 2;
+  }
+  fprintf(csv, "debounce_ms,on_ms,off_ms,timeout_ms,games,wins,completion,"
+               "avg_round_ms,avg_level\n");
+  for (const SweepResult& r : results) {
+    fprintf(csv, "%u,%u,%u,%u,%u,%u,%.4f,%.1f,%.3f\n",
+            r.debounceMs, r.onMs, r.offMs, r.timeoutMs, r.games, r.wins,
+            r.games ? (double)r.wins / r.games : 0.0,
+            r.rounds ? (double)r.roundMsSum / r.rounds : 0.0,
+            r.games ? (double)r.levelSum / r.games : 0.0);
+  }
+  if (csvPath) fclose(csv);
+
+  if (binPath) {
+    FILE* bin = fopen(binPath, "wb");
+    if (!bin) {
+      fprintf(stderr, "no se pudo crear %s\n", binPath);
+      return 2;
+    }
+    fwrite(results.data(), sizeof(SweepResult), results.size(), bin);
+    fclose(bin);
+  }
+
+  uint64_t games = (uint64_t)grid.size() * cfg.games;
+  fprintf(stderr, "%zu puntos x %u partidas en %u hilos: %.2f s (%.0f partidas/s)\n",
+          grid.size(), cfg.games, (unsigned)pool.size(), secs, games / secs);
+  return 0;
+}
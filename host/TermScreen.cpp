@@ -0,0 +1,68 @@
+#include "TermScreen.h"
+
+#include <stdio.h>
+#include <unistd.h>
+
+TermScreen::TermScreen(uint8_t rows, uint8_t cols)
+  : rows_(rows), cols_(cols),
+    next_((size_t)rows * cols, Cell{' ', Default}),
+    shown_((size_t)rows * cols, Cell{' ', Default}) {
+  out_.reserve(4096);
+  invalidate();
+}
+
+void TermScreen::clear() {
+  for (Cell& c : next_) c = Cell{' ', Default};
+}
+
+void TermScreen::put(uint8_t row, uint8_t col, const char* text, uint8_t color) {
+  if (row >= rows_) return;
+  for (; *text && col < cols_; ++text, ++col) {
+    next_[(size_t)row * cols_ + col] = Cell{*text, color};
+  }
+}
+
+void TermScreen::invalidate() {
+  // celdas imposibles: todo queda distinto
+  for (Cell& c : shown_) c = Cell{'\0', 0xFF};
+}
+
+size_t TermScreen::flush(int fd) {
+  out_.clear();
+  size_t changed = 0;
+  int cursor = -1;          // posición donde quedó el cursor
+  uint8_t color = 0xFF;     // color activo en la terminal
+  char seq[24];
+  for (uint8_t r = 0; r < rows_; ++r) {
+    for (uint8_t c = 0; c < cols_; ++c) {
+      size_t i = (size_t)r * cols_ + c;
+      if (!(next_[i] != shown_[i])) continue;
+      if (cursor != (int)i) {
+        snprintf(seq, sizeof(seq), "\x1b[%u;%uH", r + 1, c + 1);
+        out_ += seq;
+      }
+      if (next_[i].color != color) {
+        color = next_[i].color;
+        snprintf(seq, sizeof(seq), "\x1b[%um", color);
+        out_ += seq;
+      }
+      out_ += next_[i].ch;
+      shown_[i] = next_[i];
+      // en la última columna la terminal puede saltar de línea: reubicar
+      cursor = c + 1 < cols_ ? (int)i + 1 : -1;
+      ++changed;
+    }
+  }
+  if (changed) {
+    out_ += "\x1b[0m";
+    snprintf(seq, sizeof(seq), "\x1b[%u;1H", rows_ + 1);
+    out_ += seq;
+    size_t off = 0;
+    while (off < out_.size()) {
+      ssize_t n = write(fd, out_.data() + off, out_.size() - off);
+      if (n <= 0) break;
+      off += (size_t)n;
+    }
+  }
+  return changed;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+// Pantalla de terminal con redibujado por diferencias: se arma el cuadro
+// completo en memoria y flush() manda solo las celdas que cambiaron desde
+// el cuadro anterior, con secuencias ANSI, en un solo write().
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+class TermScreen {
+public:
+  // Colores ANSI (30 + n para el frente)
+  enum Color : uint8_t {
+    Default = 0, Red = 31, Green = 32, Yellow = 33, Blue = 34,
+    Dim = 90, Bright = 97
+  };
+
+  TermScreen(uint8_t rows, uint8_t cols);
+
+  void clear();
+  void put(uint8_t row, uint8_t col, const char* text, uint8_t color = Default);
+
+  // Escribe en fd los cambios; devuelve cuántas celdas se redibujaron
+  size_t flush(int fd);
+
+  // La próxima vez se redibuja todo (p. ej. al arrancar)
+  void invalidate();
+
+private:
+  struct Cell {
+    char ch;
+    uint8_t color;
+    bool operator!=(const Cell& o) const { return ch != o.ch || color != o.color; }
+  };
+
+  uint8_t rows_;
+  uint8_t cols_;
+  std::vector<Cell> next_;
+  std::vector<Cell> shown_;
+  std::string out_;
+};
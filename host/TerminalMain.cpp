@@ -0,0 +1,235 @@
+// Simon jugable en la terminal, sin flashear nada.
+//
+//   simon_play [--wav sonido.wav] [--tones tonos.txt] [--fps 30] [--seed S]
+//
+// Teclas 1-4 (o Q W E R) = botones de BUTTON_PINS, ESC = salir. Las
+// flechas y demás teclas especiales (ESC [ ... o ESC O x) se ignoran.
+// El juego corre en tiempo real sobre el reloj virtual; la entrada se lee
+// con poll() sin bloquear, así loop() nunca espera al teclado. La pantalla
+// se redibuja a lo sumo --fps veces por segundo y solo en las celdas que
+// cambiaron.
+
+#include "Sim.h"
+#include "LiquidCrystal.h"
+#include "TermScreen.h"
+#include "ToneWav.h"
+#include "../Pins.h"
+
+#include <chrono>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+
+void setup();
+void loop();
+
+static termios savedTerm;
+static bool rawMode = false;
+
+static void restoreTerminal() {
+  if (rawMode) {
+    tcsetattr(STDIN_FILENO, TCSANOW, &savedTerm);
+    rawMode = false;
+  }
+  // color normal, cursor visible
+  fputs("\x1b[0m\x1b[?25h\n", stdout);
+  fflush(stdout);
+}
+
+static void onSignal(int) {
+  restoreTerminal();
+  _exit(130);
+}
+
+static void enterRawMode() {
+  if (!isatty(STDIN_FILENO) || tcgetattr(STDIN_FILENO, &savedTerm) != 0) return;
+  termios raw = savedTerm;
+  raw.c_lflag &= ~(ICANON | ECHO);
+  raw.c_cc[VMIN] = 0;
+  raw.c_cc[VTIME] = 0;
+  if (tcsetattr(STDIN_FILENO, TCSANOW, &raw) == 0) rawMode = true;
+}
+
+struct ToneOut {
+  ToneWav wav;
+  FILE* text = nullptr;
+};
+
+static void onTone(unsigned int freq, uint64_t endUs, void* ctx) {
+  ToneOut* out = (ToneOut*)ctx;
+  uint64_t now = sim::board().nowUs;
+  if (out->text) {
+    if (freq) {
+      fprintf(out->text, "%10.1f ms  %5u Hz  %s%.0f ms\n", now / 1000.0, freq,
+              endUs ? "" : "sin fin ", endUs ? (endUs - now) / 1000.0 : 0.0);
+    } else {
+      fprintf(out->text, "%10.1f ms  silencio\n", now / 1000.0);
+    }
+  }
+  out->wav.toneEvent(freq, endUs);
+}
+
+static int keyToButton(int c) {
+  switch (c) {
+    case '1': case 'q': case 'Q': return 0;
+    case '2': case 'w': case 'W': return 1;
+    case '3': case 'e': case 'E': return 2;
+    case '4': case 'r': case 'R': return 3;
+  }
+  return -1;
+}
+
+int main(int argc, char** argv) {
+  const char* wavPath = nullptr;
+  const char* tonesPath = nullptr;
+  unsigned fps = 30;
+  uint32_t seed = (uint32_t)time(nullptr);
+  for (int i = 1; i + 1 < argc; i += 2) {
+    if (!strcmp(argv[i], "--wav")) wavPath = argv[i + 1];
+    else if (!strcmp(argv[i], "--tones")) tonesPath = argv[i + 1];
+    else if (!strcmp(argv[i], "--fps")) fps = (unsigned)atoi(argv[i + 1]);
+    else if (!strcmp(argv[i], "--seed")) seed = (uint32_t)strtoul(argv[i + 1], nullptr, 10);
+    else {
+      fprintf(stderr, "opción desconocida: %s\n", argv[i]);
+      return 2;
+    }
+  }
+  if (fps == 0) fps = 30;
+
+  sim::reset(seed);
+  ToneOut tones;
+  if (wavPath && !tones.wav.open(wavPath)) {
+    fprintf(stderr, "no se pudo crear %s\n", wavPath);
+    return 2;
+  }
+  if (tonesPath && !(tones.text = fopen(tonesPath, "w"))) {
+    fprintf(stderr, "no se pudo crear %s\n", tonesPath);
+    return 2;
+  }
+  sim::board().onTone = onTone;
+  sim::board().onToneCtx = &tones;
+
+  enterRawMode();
+  atexit(restoreTerminal);
+  signal(SIGINT, onSignal);
+  signal(SIGTERM, onSignal);
+  fputs("\x1b[2J\x1b[?25l", stdout);
+  fflush(stdout);
+
+  static const uint8_t ledColors[4] = {
+    TermScreen::Red, TermScreen::Green, TermScreen::Blue, TermScreen::Yellow
+  };
+  static const char* const keyNames[4] = {"1/Q", "2/W", "3/E", "4/R"};
+  const unsigned long passUs = 200;
+  const unsigned long holdMs = 120;   // la terminal no avisa al soltar
+  unsigned long releaseAt[4] = {0, 0, 0, 0};
+
+  TermScreen screen(12, 40);
+  setup();
+
+  using Clock = std::chrono::steady_clock;
+  const Clock::time_point t0 = Clock::now();
+  const auto framePeriod = std::chrono::microseconds(1000000 / fps);
+  Clock::time_point nextFrame = t0;
+  unsigned long frames = 0, cells = 0;
+  bool running = true;
+  // ESC solo sale; seguido de [ u O es una tecla especial hasta el byte final
+  enum { kKey, kEsc, kSeq } esc = kKey;
+
+  while (running) {
+    // la simulación alcanza al reloj real
+    uint64_t realUs = (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        Clock::now() - t0).count();
+    while (sim::board().nowUs < realUs) {
+      unsigned long now = millis();
+      for (uint8_t i = 0; i < 4; ++i) {
+        if (releaseAt[i] && (long)(now - releaseAt[i]) >= 0) {
+          sim::setInput(BUTTON_PINS[i], HIGH);
+          releaseAt[i] = 0;
+        }
+      }
+      loop();
+      sim::advance(passUs);
+    }
+
+    if (Clock::now() >= nextFrame) {
+      nextFrame += framePeriod;
+      if (nextFrame < Clock::now()) nextFrame = Clock::now() + framePeriod;
+
+      screen.clear();
+      screen.put(0, 1, "SIMON DICE - simulador", TermScreen::Bright);
+      screen.put(1, 1, "+----------------+");
+      const LiquidCrystal* lcd = sim::board().lcd;
+      char row[LiquidCrystal::kLineLen + 1];
+      for (uint8_t r = 0; r < 2; ++r) {
+        if (lcd) lcd->visibleRow(r, row); else strcpy(row, "                ");
+        screen.put(2 + r, 1, "|");
+        screen.put(2 + r, 2, row, TermScreen::Green);
+        screen.put(2 + r, 18, "|");
+      }
+      screen.put(4, 1, "+----------------+");
+      for (uint8_t i = 0; i < 4; ++i) {
+        bool on = sim::pinLevel(LED_PINS[i]) == HIGH;
+        screen.put(6, (uint8_t)(1 + i * 7), on ? "[####]" : "[....]",
+                   on ? ledColors[i] : (uint8_t)TermScreen::Dim);
+        screen.put(7, (uint8_t)(2 + i * 7), keyNames[i],
+                   releaseAt[i] ? TermScreen::Bright : TermScreen::Dim);
+      }
+      char line[48];
+      unsigned int freq = sim::toneNow();
+      if (freq) snprintf(line, sizeof(line), "buzzer: %u Hz", freq);
+      else snprintf(line, sizeof(line), "buzzer: -");
+      screen.put(9, 1, line, freq ? TermScreen::Yellow : TermScreen::Dim);
+      screen.put(10, 1, "teclas 1-4 / Q W E R, ESC para salir", TermScreen::Dim);
+      snprintf(line, sizeof(line), "cuadros: %lu  celdas: %lu", frames, cells);
+      screen.put(11, 1, line, TermScreen::Dim);
+
+      size_t n = screen.flush(STDOUT_FILENO);
+      if (n) {
+        ++frames;
+        cells += n;
+      }
+    }
+
+    // espera corta: vuelve apenas hay una tecla o toca otra pasada
+    pollfd pfd = {STDIN_FILENO, POLLIN, 0};
+    if (poll(&pfd, 1, 1) > 0 && (pfd.revents & POLLIN)) {
+      char keys[16];
+      ssize_t n = read(STDIN_FILENO, keys, sizeof(keys));
+      if (n == 0) running = false;   // fin de la entrada
+      for (ssize_t k = 0; k < n; ++k) {
+        unsigned char c = (unsigned char)keys[k];
+        if (esc == kEsc) {
+          // ESC + otra tecla (Alt) tampoco hace nada
+          esc = c == '[' || c == 'O' ? kSeq : kKey;
+          continue;
+        }
+        if (esc == kSeq) {
+          if (c >= 0x40 && c <= 0x7E) esc = kKey;
+          continue;
+        }
+        if (c == 0x1b) {
+          esc = kEsc;
+          continue;
+        }
+        int btn = keyToButton(c);
+        if (btn >= 0) {
+          sim::setInput(BUTTON_PINS[btn], LOW);
+          releaseAt[btn] = millis() + holdMs;
+        }
+      }
+      // un ESC que no sigue con nada es la tecla sola
+      if (esc == kEsc) {
+        pollfd more = {STDIN_FILENO, POLLIN, 0};
+        if (poll(&more, 1, 30) <= 0) running = false;
+      }
+    }
+  }
+
+  tones.wav.close();
+  if (tones.text) fclose(tones.text);
+  return 0;
+}
@@ -0,0 +1,85 @@
+#include "ToneWav.h"
+
+static void put32(uint8_t* p, uint32_t v) {
+  for (uint8_t i = 0; i < 4; ++i) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static void put16(uint8_t* p, uint16_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+}
+
+static void writeHeader(FILE* f, uint32_t samples) {
+  uint8_t h[44];
+  memcpy(h, "RIFF", 4);
+  put32(h + 4, 36 + samples);
+  memcpy(h + 8, "WAVEfmt ", 8);
+  put32(h + 16, 16);
+  put16(h + 20, 1);                 // PCM
+  put16(h + 22, 1);                 // mono
+  put32(h + 24, ToneWav::kRate);
+  put32(h + 28, ToneWav::kRate);    // bytes por segundo
+  put16(h + 32, 1);
+  put16(h + 34, 8);
+  memcpy(h + 36, "data", 4);
+  put32(h + 40, samples);
+  fseek(f, 0, SEEK_SET);
+  fwrite(h, 1, sizeof(h), f);
+}
+
+bool ToneWav::open(const char* path) {
+  file_ = fopen(path, "wb");
+  if (!file_) return false;
+  writeHeader(file_, 0);
+  samples_ = 0;
+  startUs_ = renderedUs_ = sim::board().nowUs;
+  freq_ = 0;
+  return true;
+}
+
+void ToneWav::attach() {
+  sim::board().onTone = &ToneWav::onTone;
+  sim::board().onToneCtx = this;
+}
+
+void ToneWav::onTone(unsigned int freq, uint64_t endUs, void* ctx) {
+  ((ToneWav*)ctx)->toneEvent(freq, endUs);
+}
+
+void ToneWav::toneEvent(unsigned int freq, uint64_t endUs) {
+  if (!file_) return;
+  renderUntil(sim::board().nowUs);
+  freq_ = freq;
+  endUs_ = endUs;
+}
+
+void ToneWav::renderUntil(uint64_t us) {
+  uint8_t buf[512];
+  size_t n = 0;
+  while (renderedUs_ < us) {
+    bool sounding = freq_ && (!endUs_ || renderedUs_ < endUs_);
+    uint8_t v = 128;
+    if (sounding) {
+      phase_ = (phase_ + freq_) % kRate;
+      v = phase_ < kRate / 2 ? 200 : 56;
+    }
+    buf[n++] = v;
+    if (n == sizeof(buf)) {
+      fwrite(buf, 1, n, file_);
+      n = 0;
+    }
+    ++samples_;
+    // siguiente muestra, sin acumular error de redondeo
+    renderedUs_ = startUs_ + (uint64_t)samples_ * 1000000ULL / kRate;
+  }
+  if (n) fwrite(buf, 1, n, file_);
+}
+
+void ToneWav::close() {
+  if (!file_) return;
+  renderUntil(sim::board().nowUs);
+  writeHeader(file_, samples_);
+  fclose(file_);
+  file_ = nullptr;
+  if (sim::board().onToneCtx == this) sim::board().onTone = nullptr;
+}
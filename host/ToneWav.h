@@ -0,0 +1,40 @@
+#pragma once
+
+// Convierte los tone() del sketch en un WAV de onda cuadrada (8 bits mono),
+// siguiendo el reloj virtual. Se engancha en sim::Board::onTone.
+
+#include "Sim.h"
+
+#include <stdio.h>
+
+class ToneWav {
+public:
+  static const uint32_t kRate = 16000;
+
+  ToneWav() : file_(nullptr), samples_(0), startUs_(0), renderedUs_(0), freq_(0),
+              endUs_(0), phase_(0) {}
+  ~ToneWav() { close(); }
+
+  bool open(const char* path);
+
+  // Engancha la placa activa: cada tone() queda en el archivo
+  void attach();
+
+  // Para quien ya usa sim::Board::onTone: pasar cada aviso acá
+  void toneEvent(unsigned int freq, uint64_t endUs);
+
+  // Completa el audio hasta el tiempo virtual actual y cierra el archivo
+  void close();
+
+private:
+  FILE* file_;
+  uint32_t samples_;
+  uint64_t startUs_;
+  uint64_t renderedUs_;
+  unsigned int freq_;
+  uint64_t endUs_;
+  uint32_t phase_;          // fase de la onda en 1/kRate de ciclo
+
+  void renderUntil(uint64_t us);
+  static void onTone(unsigned int freq, uint64_t endUs, void* ctx);
+};
@@ -0,0 +1,107 @@
+#include "TraceRecorder.h"
+#include "Sim.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+namespace trace {
+
+struct Event {
+  const char* name;
+  uint64_t ts;   // µs virtuales
+  char phase;    // 'B', 'E' o 'i'
+};
+
+static Event* events_ = nullptr;
+static uint32_t capacity_ = 0;
+static uint32_t count_ = 0;
+static uint32_t dropped_ = 0;
+static uint32_t open_ = 0;      // tramos abiertos que sí se grabaron
+static uint32_t skipped_ = 0;   // tramos abiertos que se descartaron
+static const char* path_ = nullptr;
+
+static void writeAtExit() {
+  if (path_) writeJson(path_);
+}
+
+void start(const char* path, uint32_t capacity) {
+  if (events_) return;
+  events_ = (Event*)calloc(capacity, sizeof(Event));
+  if (!events_) return;
+  capacity_ = capacity;
+  path_ = path;
+  if (path_) atexit(writeAtExit);
+}
+
+static inline void push(const char* name, char phase) {
+  Event& e = events_[count_++];
+  e.name = name;
+  e.ts = sim::board().nowUs;
+  e.phase = phase;
+}
+
+void begin(const char* name) {
+  if (!events_) return;
+  // siempre queda lugar para cerrar los tramos ya abiertos
+  if (skipped_ || count_ + open_ + 2 > capacity_) {
+    ++skipped_;
+    ++dropped_;
+    return;
+  }
+  ++open_;
+  push(name, 'B');
+}
+
+void end(const char* name) {
+  if (!events_) return;
+  if (skipped_) {
+    --skipped_;
+    return;
+  }
+  if (!open_) return;
+  --open_;
+  // vacío y sin tiempo: se borra el inicio en vez de grabar el fin
+  if (count_ && events_[count_ - 1].phase == 'B' &&
+      events_[count_ - 1].ts == sim::board().nowUs) {
+    --count_;
+    return;
+  }
+  push(name, 'E');
+}
+
+void instant(const char* name) {
+  if (!events_) return;
+  if (count_ + open_ + 1 > capacity_) {
+    ++dropped_;
+    return;
+  }
+  push(name, 'i');
+}
+
+bool writeJson(const char* path) {
+  FILE* f = fopen(path, "w");
+  if (!f) return false;
+  fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", f);
+  fputs("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,"
+        "\"args\":{\"name\":\"Simon (simulador)\"}}", f);
+  for (uint32_t i = 0; i < count_; ++i) {
+    const Event& e = events_[i];
+    fprintf(f, ",\n{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%llu,\"pid\":1,\"tid\":1%s}",
+            e.name, e.phase, (unsigned long long)e.ts,
+            e.phase == 'i' ? ",\"s\":\"t\"" : "");
+  }
+  // tramos que siguen abiertos al salir se cierran en el último instante
+  uint64_t last = count_ ? events_[count_ - 1].ts : 0;
+  for (uint32_t i = 0; i < open_; ++i) {
+    fprintf(f, ",\n{\"ph\":\"E\",\"ts\":%llu,\"pid\":1,\"tid\":1}",
+            (unsigned long long)last);
+  }
+  fputs("\n]}\n", f);
+  fclose(f);
+  return true;
+}
+
+uint32_t recorded() { return count_; }
+uint32_t dropped() { return dropped_; }
+
+}  // namespace trace
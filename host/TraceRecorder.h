@@ -0,0 +1,40 @@
+#pragma once
+
+// Grabador de trazas del simulador.
+// Guarda inicios/fines de tramos y eventos instantáneos con el tiempo
+// virtual en un búfer reservado al arrancar (sin asignaciones mientras corre
+// el juego) y al final lo escribe como JSON de "Trace Event Format", que se
+// abre en chrome://tracing o en ui.perfetto.dev.
+//
+// Un tramo que no tiene nada adentro y en el que no pasó tiempo virtual no
+// queda grabado: los handlers que se llaman en cada pasada solo aparecen
+// cuando hacen algo (un cambio de estado, de LEDs o de sonido es un
+// evento instantáneo adentro). Sin eso, 50 partidas llenaban el búfer.
+
+#include <stdint.h>
+
+namespace trace {
+
+// Reserva el búfer y registra la escritura del JSON al salir del programa
+void start(const char* path, uint32_t capacity = 1u << 20);
+
+void begin(const char* name);
+void end(const char* name);
+void instant(const char* name);
+
+// Escribe lo grabado hasta ahora; devuelve false si no se pudo abrir path
+bool writeJson(const char* path);
+
+uint32_t recorded();
+uint32_t dropped();
+
+class Scope {
+public:
+  explicit Scope(const char* name) : name_(name) { begin(name_); }
+  ~Scope() { end(name_); }
+
+private:
+  const char* name_;
+};
+
+}  // namespace trace
@@ -0,0 +1,216 @@
+// Modo versus en la PC: dos placas simuladas, cada una con su jugador
+// sintético, unidas por dos pipes que hacen de cable TX-RX cruzado.
+//
+//   simon_versus [--games N] [--latency MS] [--error PERMILLE] [--seed S]
+//                [--no-comp]
+//
+// Las placas avanzan juntas en tiempo virtual (siempre corre la más
+// atrasada). Por el pipe viaja cada byte con el instante virtual en que
+// termina de llegar: 115200 baudios más --latency de demora fija. Al final
+// mide el desfase entre los dos tableros al largar cada ronda compartida y
+// el costo real de VersusLink::update() por pasada.
+
+#include "Sim.h"
+#include "Station.h"
+#include "Player.h"
+#include "../VersusLink.h"
+
+#include <chrono>
+#include <deque>
+#include <fcntl.h>
+#include <map>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+// 10 bits por byte a 115200 baudios
+static const uint64_t kByteUs = 87;
+
+// Lo que viaja por el pipe: un byte y cuándo llega al otro lado
+struct WireByte {
+  uint64_t dueUs;
+  uint8_t c;
+};
+
+struct Side {
+  sim::Board board;
+  Station st;
+  VersusLink link;
+  SyntheticPlayer player;
+  int txFd = -1;
+  int rxFd = -1;
+  uint64_t lineFreeUs = 0;          // fin del último byte enviado
+  uint64_t latencyUs = 0;
+  std::deque<WireByte> inbox;       // leído del pipe, todavía en viaje
+  uint32_t markedSeed = 0;
+  uint8_t markedLevel = 0;
+  std::map<uint64_t, uint64_t> roundStartUs;   // (semilla, nivel) -> primer LED
+  State last = State::IDLE;
+  uint32_t games = 0, wins = 0, shared = 0;
+  uint64_t updates = 0, costNsSum = 0, costNsMax = 0;
+
+  Side(const PlayerConfig& pc)
+    : link(Serial, st.game, st.display),
+      player(BUTTON_PINS, LED_PINS, 4, pc) {}
+};
+
+static void onSerialTx(uint8_t c, void* ctx) {
+  Side* s = (Side*)ctx;
+  uint64_t now = s->board.nowUs;
+  if (s->lineFreeUs < now) s->lineFreeUs = now;
+  s->lineFreeUs += kByteUs;
+  WireByte w = {s->lineFreeUs + s->latencyUs, c};
+  if (write(s->txFd, &w, sizeof(w)) != (ssize_t)sizeof(w)) perror("write");
+}
+
+// Primer LED de cada ronda: el momento en que el jugador empieza a ver
+static void onPin(uint8_t pin, uint8_t level, void* ctx) {
+  Side* s = (Side*)ctx;
+  if (level != HIGH || s->st.game.state() != State::SHOW_PATTERN) return;
+  bool led = false;
+  for (uint8_t i = 0; i < 4; ++i) led |= LED_PINS[i] == pin;
+  uint32_t seed = s->st.game.seed();
+  uint8_t lvl = s->st.game.level();
+  if (!led || (seed == s->markedSeed && lvl == s->markedLevel)) return;
+  s->markedSeed = seed;
+  s->markedLevel = lvl;
+  s->roundStartUs[((uint64_t)seed << 8) | lvl] = s->board.nowUs;
+}
+
+// Pasa del pipe a Serial lo que ya llegó a esta placa
+static void pumpWire(Side& s) {
+  WireByte w[64];
+  ssize_t n;
+  while ((n = read(s.rxFd, w, sizeof(w))) > 0) {
+    for (ssize_t i = 0; i < n / (ssize_t)sizeof(WireByte); ++i) s.inbox.push_back(w[i]);
+  }
+  while (!s.inbox.empty() && s.inbox.front().dueUs <= s.board.nowUs) {
+    if (sim::serialInput(&s.inbox.front().c, 1) == 0) break;
+    s.inbox.pop_front();
+  }
+}
+
+static void step(Side& s, unsigned long passUs) {
+  sim::use(&s.board);
+  pumpWire(s);
+  Instant now = Clock::now();
+  s.st.game.loop(now);
+  s.player.update();
+
+  auto t0 = std::chrono::steady_clock::now();
+  s.link.update(now);
+  uint64_t ns = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - t0).count();
+  ++s.updates;
+  s.costNsSum += ns;
+  if (ns > s.costNsMax) s.costNsMax = ns;
+
+  State st = s.st.game.state();
+  if (st != s.last && st == State::GAME_OVER) {
+    ++s.games;
+    if (s.st.game.won()) ++s.wins;
+    if (s.link.joined()) ++s.shared;
+  }
+  s.last = st;
+  sim::advance(passUs);
+}
+
+int main(int argc, char** argv) {
+  uint32_t games = 20;
+  unsigned latencyMs = 20;
+  uint16_t errorPermille = 150;
+  uint32_t seed = 1;
+  bool compensate = true;
+  for (int i = 1; i < argc; ++i) {
+    if (!strcmp(argv[i], "--no-comp")) compensate = false;
+    else if (i + 1 < argc && !strcmp(argv[i], "--games")) games = (uint32_t)strtoul(argv[++i], nullptr, 10);
+    else if (i + 1 < argc && !strcmp(argv[i], "--latency")) latencyMs = (unsigned)atoi(argv[++i]);
+    else if (i + 1 < argc && !strcmp(argv[i], "--error")) errorPermille = (uint16_t)atoi(argv[++i]);
+    else if (i + 1 < argc && !strcmp(argv[i], "--seed")) seed = (uint32_t)strtoul(argv[++i], nullptr, 10);
+    else {
+      fprintf(stderr, "opción desconocida: %s\n", argv[i]);
+      return 2;
+    }
+  }
+
+  // wire[0]: A -> B, wire[1]: B -> A
+  int wire[2][2];
+  if (pipe(wire[0]) != 0 || pipe(wire[1]) != 0) {
+    perror("pipe");
+    return 1;
+  }
+  for (int i = 0; i < 2; ++i) fcntl(wire[i][0], F_SETFL, fcntl(wire[i][0], F_GETFL) | O_NONBLOCK);
+
+  PlayerConfig pc;
+  pc.errorPermille = errorPermille;
+  Side* sides[2];
+  for (int i = 0; i < 2; ++i) {
+    pc.seed = seed * 2 + (uint32_t)i + 1;
+    pc.reactionMs = 250 + 100 * (unsigned)i;   // B un poco más lento
+    sides[i] = new Side(pc);
+    Side& s = *sides[i];
+    s.txFd = wire[i][1];
+    s.rxFd = wire[1 - i][0];
+    s.latencyUs = (uint64_t)latencyMs * 1000;
+    sim::use(&s.board);
+    sim::reset(seed * 7919u + (uint32_t)i * 104729u);
+    s.board.serialTx = onSerialTx;
+    s.board.serialTxCtx = &s;
+    s.board.onPin = onPin;
+    s.board.onPinCtx = &s;
+    s.st.begin();
+    s.link.begin();
+    s.link.setCompensation(compensate);
+    s.player.setGamesToPlay(games);
+  }
+
+  const unsigned long passUs = 200;
+  const uint64_t limitUs = 4ULL * 3600 * 1000000;
+  auto t0 = std::chrono::steady_clock::now();
+  for (;;) {
+    Side& a = *sides[0];
+    Side& b = *sides[1];
+    bool finished = a.player.done() && b.player.done() &&
+                    a.st.game.state() == State::IDLE && b.st.game.state() == State::IDLE;
+    if (finished || a.board.nowUs > limitUs) break;
+    step(a.board.nowUs <= b.board.nowUs ? a : b, passUs);
+  }
+  double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  sim::use(nullptr);
+
+  // desfase al largar las rondas que jugaron los dos
+  uint64_t rounds = 0, skewSum = 0, skewMax = 0;
+  for (const auto& kv : sides[0]->roundStartUs) {
+    auto it = sides[1]->roundStartUs.find(kv.first);
+    if (it == sides[1]->roundStartUs.end()) continue;
+    uint64_t d = kv.second > it->second ? kv.second - it->second : it->second - kv.second;
+    ++rounds;
+    skewSum += d;
+    if (d > skewMax) skewMax = d;
+  }
+
+  for (int i = 0; i < 2; ++i) {
+    const Side& s = *sides[i];
+    printf("placa %c: %u partidas (%u ganadas, %u compartidas)  demora medida %u ms  "
+           "tramas %u enviadas / %u recibidas / %u malas\n",
+           'A' + i, s.games, s.wins, s.shared, s.link.oneWayMs(),
+           s.link.framesOut(), s.link.framesIn(), s.link.badFrames());
+    printf("         update(): %.0f ns de media, %llu ns de máximo en %llu pasadas "
+           "(a lo sumo %u bytes leídos y 1 trama por pasada)\n",
+           s.updates ? (double)s.costNsSum / s.updates : 0.0,
+           (unsigned long long)s.costNsMax, (unsigned long long)s.updates,
+           VersusLink::kRxBudget);
+  }
+  printf("rondas compartidas: %llu  desfase al largar: %.2f ms de media, %.2f ms de máximo "
+         "(latencia %u ms, compensación %s)\n",
+         (unsigned long long)rounds, rounds ? skewSum / 1000.0 / rounds : 0.0,
+         skewMax / 1000.0, latencyMs, compensate ? "sí" : "no");
+  printf("%.1f s virtuales en %.2f s\n", sides[0]->board.nowUs / 1e6, secs);
+
+  for (int i = 0; i < 2; ++i) {
+    close(wire[i][0]);
+    close(wire[i][1]);
+    delete sides[i];
+  }
+  return 0;
+}
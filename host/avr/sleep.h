@@ -0,0 +1,12 @@
+#pragma once
+
+// <avr/sleep.h> en el simulador: sleep_mode() no detiene el reloj, solo
+// marca que el próximo sim::advance() es tiempo dormido (para el consumo,
+// Energy.h). Se duerme siempre en SLEEP_MODE_IDLE.
+
+#include <stdint.h>
+
+#define SLEEP_MODE_IDLE 0
+
+inline void set_sleep_mode(uint8_t) {}
+void sleep_mode();
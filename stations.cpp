@@ -0,0 +1,87 @@
+#include <Arduino.h>
+#include "Pins.h"
+
+// Varias estaciones en una Mega (compilar con -DSIMON_STATIONS=2 o 3, ver
+// Stations.h). Sin grabación, versus ni consola: usan el único Serial.
+#if SIMON_STATIONS > 1
+
+#include "Stations.h"
+#include "StackPaint.h"
+#include "SizeReport.h"
+#include <avr/sleep.h>
+
+#if defined(SIMON_RECORD) || defined(SIMON_REPLAY) || defined(SIMON_VERSUS) || \
+    defined(SIMON_CONSOLE)
+#error "con varias estaciones no hay grabación, versus ni consola"
+#endif
+
+// Compartido por todas las estaciones
+
+EepromQueue    eeQueue;
+Scheduler      scheduler;
+ToneEngine     audio;
+
+static_assert(2 * SIMON_STATIONS <= Scheduler::kMaxTasks,
+              "cada modo de atracción usa dos tareas del Scheduler");
+static_assert(SIMON_STATIONS <= ToneEngine::kMaxVoices, "una voz por estación");
+
+#ifdef __AVR__
+ISR(EE_READY_vect) {
+  eeQueue.service();
+}
+#else
+static void eeReadyIsr() {
+  eeQueue.service();
+}
+#endif
+
+// Las estaciones
+
+GameStation    station0(STATION_PINS[0], scheduler);
+GameStation    station1(STATION_PINS[1], scheduler);
+#if SIMON_STATIONS > 2
+GameStation    station2(STATION_PINS[2], scheduler);
+#endif
+
+GameStation* stations[SIMON_STATIONS] = {
+  &station0, &station1,
+#if SIMON_STATIONS > 2
+  &station2,
+#endif
+};
+
+SIMON_REPORT_SIZE(GameStation);
+SIMON_REPORT_SIZE(ToneEngine);
+
+// LOOP
+
+void setup() {
+#ifndef __AVR__
+  stackPaint();
+  eepromSetReadyIsr(eeReadyIsr);
+#endif
+  for (uint8_t i = 0; i < SIMON_STATIONS; ++i) stations[i]->begin(i, audio);
+}
+
+void loop() {
+  // un instante para todas las estaciones (TimeBase.h)
+  Instant now = Clock::now();
+  bool allAttract = true;
+  for (uint8_t i = 0; i < SIMON_STATIONS; ++i) {
+    stations[i]->loop(now, eeQueue);
+    // con el LCD a medio escribir tampoco se duerme
+    allAttract = allAttract && stations[i]->attract.active() &&
+                 !stations[i]->screen.pending();
+  }
+  uint16_t idleMs = scheduler.run(now);
+  // los clicks y las notas que se pidieron en esta pasada
+  audio.update(now);
+
+  // como en main.cpp, pero solo si ninguna estación está jugando
+  if (allAttract && idleMs > 0) {
+    set_sleep_mode(SLEEP_MODE_IDLE);
+    sleep_mode();
+  }
+}
+
+#endif  // SIMON_STATIONS > 1